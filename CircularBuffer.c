@@ -6,7 +6,58 @@
 #include <limits.h>
 #include <sys/mman.h>
 #include <sys/syscall.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <linux/falloc.h>
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <linux/memfd.h>
+#include <linux/mempolicy.h>
+#include <sched.h>
 #include <unistd.h>
+#include <fcntl.h>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <immintrin.h>
+#define CIRCULARBUFFER_COPY_X86
+#endif
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+#define CIRCULARBUFFER_URING_MAX_BUFFER ( (size_t) 1 << 30 ) //kernel cap on the length of a registered buffer
+
+/**
+ * [PRIVATE] Pending zero-copy reservation
+ * @param cbuff  Pointer to the CircularBuffer_t object reserved on (NULL when none)
+ * @param cursor Start of the reserved range
+ * @param length Length of the reserved range in bytes
+ */
+typedef struct CircularBuffer_Reservation {
+    CircularBuffer_t * cbuff;
+    u_int64_t          cursor;
+    size_t             length;
+} CircularBuffer_Reservation_t;
+
+/**
+ * [PRIVATE] Calling thread's pending `reserveWrite(..)` reservation
+ */
+static _Thread_local CircularBuffer_Reservation_t CircularBuffer_writeReservation = { NULL, 0, 0 };
+
+/**
+ * [PRIVATE] Calling thread's pending `peekRead(..)` reservation
+ */
+static _Thread_local CircularBuffer_Reservation_t CircularBuffer_readReservation = { NULL, 0, 0 };
+
+/**
+ * [PRIVATE] io_uring engine claiming ranges on the calling thread (`uringRun(..)`), NULL otherwise
+ */
+static _Thread_local const CircularBuffer_Uring_t * CircularBuffer_engine = NULL;
 
 /**
  * Gets a string representation of the error enum val for pthread returns
@@ -31,287 +82,3175 @@ static const char * CircularBuffer_getPThreadErrStr( int i ) {
 }
 
 /**
- * [PRIVATE] Gets a file descriptor for an anonymous file residing in memory (replica of https://man7.org/linux/man-pages/man2/memfd_create.2.html)
- * @param name  Name of file
- * @param flags Flags
- * @return File descriptor (-1 or error)
+ * [PRIVATE] Gets a file descriptor for an anonymous file residing in memory (replica of https://man7.org/linux/man-pages/man2/memfd_create.2.html)
+ * @param name  Name of file
+ * @param flags Flags
+ * @return File descriptor (-1 or error)
+ */
+static int CircularBuffer_memfd_create( const char * name, unsigned int flags ) {
+    long fd   = syscall( __NR_memfd_create, name, flags );
+    int  cast = 0;
+
+    if( fd >= 0 ) {
+        if( fd <= INT_MAX ) {
+            cast = (int) fd;
+
+        } else {
+            fprintf( stderr,
+                     "[CircularBuffer_memfd_create( \"%s\", %d )] Failed cast long->int (%ld)\n",
+                     name, flags, fd
+            );
+
+            cast = -1;
+        }
+    }
+
+    return cast;
+}
+
+/**
+ * [PRIVATE] Moves data between a pipe and a file descriptor (replica of https://man7.org/linux/man-pages/man2/splice.2.html)
+ * @param fd_in   Input file descriptor
+ * @param off_in  Pointer to input offset (NULL for pipes)
+ * @param fd_out  Output file descriptor
+ * @param off_out Pointer to output offset (NULL for pipes)
+ * @param len     Max number of bytes to move
+ * @param flags   Flags
+ * @return Number of bytes moved (-1 on error)
+ */
+static ssize_t CircularBuffer_splice( int fd_in, loff_t * off_in, int fd_out, loff_t * off_out, size_t len, unsigned int flags ) {
+    return (ssize_t) syscall( __NR_splice, fd_in, off_in, fd_out, off_out, len, flags );
+}
+
+/**
+ * [PRIVATE] Manipulates the allocated space of a file (replica of https://man7.org/linux/man-pages/man2/fallocate.2.html)
+ * @param fd     File descriptor
+ * @param mode   Operation flags
+ * @param offset Start of the range
+ * @param len    Length of the range in bytes
+ * @return 0 on success (-1 on error)
+ */
+static int CircularBuffer_fallocate( int fd, int mode, off_t offset, off_t len ) {
+    return (int) syscall( __NR_fallocate, fd, mode, offset, len );
+}
+
+/**
+ * [PRIVATE] Sets up an io_uring instance (replica of https://man7.org/linux/man-pages/man2/io_uring_setup.2.html)
+ * @param entries Number of submission queue entries
+ * @param params  Setup parameters (filled in with the ring offsets)
+ * @return io_uring file descriptor (-1 on error)
+ */
+static int CircularBuffer_io_uring_setup( unsigned entries, struct io_uring_params * params ) {
+    return (int) syscall( __NR_io_uring_setup, entries, params );
+}
+
+/**
+ * [PRIVATE] Submits and/or waits for io_uring requests (replica of https://man7.org/linux/man-pages/man2/io_uring_enter.2.html)
+ * @param fd           io_uring file descriptor
+ * @param to_submit    Number of queued submissions
+ * @param min_complete Number of completions to wait for
+ * @param flags        Flags
+ * @return Number of submissions consumed (-1 on error)
+ */
+static int CircularBuffer_io_uring_enter( int fd, unsigned to_submit, unsigned min_complete, unsigned flags ) {
+    return (int) syscall( __NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0 );
+}
+
+/**
+ * [PRIVATE] Registers resources with an io_uring instance (replica of https://man7.org/linux/man-pages/man2/io_uring_register.2.html)
+ * @param fd     io_uring file descriptor
+ * @param opcode Registration opcode
+ * @param arg    Resource(s)
+ * @param nr     Number of resources
+ * @return 0 on success (-1 on error)
+ */
+static int CircularBuffer_io_uring_register( int fd, unsigned opcode, const void * arg, unsigned nr ) {
+    return (int) syscall( __NR_io_uring_register, fd, opcode, arg, nr );
+}
+
+/**
+ * [PRIVATE] Hints the CPU that the calling thread is busy-waiting
+ */
+static inline void CircularBuffer_cpuRelax( void ) {
+#if defined( __x86_64__ ) || defined( __i386__ )
+    __builtin_ia32_pause();
+#elif defined( __aarch64__ ) || defined( __arm__ )
+    __asm__ __volatile__( "yield" ::: "memory" );
+#else
+    atomic_signal_fence( memory_order_seq_cst );
+#endif
+}
+
+/**
+ * [PRIVATE] Sleeps on a futex word as long as it holds the expected value
+ * @param word     Pointer to futex word
+ * @param expected Expected value
+ * @param deadline Absolute CLOCK_MONOTONIC deadline (NULL for none)
+ * @return Deadline not reached
+ */
+static bool CircularBuffer_futexWait( _Atomic u_int32_t * word, u_int32_t expected, const struct timespec * deadline ) {
+    //FUTEX_WAIT_BITSET takes an absolute timeout on CLOCK_MONOTONIC (FUTEX_WAIT takes a relative one)
+    const long ret = syscall( SYS_futex, (u_int32_t *) word, FUTEX_WAIT_BITSET_PRIVATE, expected, deadline, NULL, FUTEX_BITSET_MATCH_ANY );
+
+    return !( ret < 0 && errno == ETIMEDOUT );
+}
+
+/**
+ * [PRIVATE] Waits on a condition (mutex held by caller)
+ * @param cond     Condition
+ * @param mutex    Mutex associated with the condition
+ * @param deadline Absolute CLOCK_MONOTONIC deadline (NULL for none)
+ * @return Deadline not reached
+ */
+static bool CircularBuffer_condWait( pthread_cond_t * cond, pthread_mutex_t * mutex, const struct timespec * deadline ) {
+    if( deadline == NULL )
+        return ( pthread_cond_wait( cond, mutex ), true ); //EARLY RETURN
+
+    return ( pthread_cond_timedwait( cond, mutex, deadline ) != ETIMEDOUT );
+}
+
+/**
+ * [PRIVATE] Wakes threads sleeping on a futex word
+ * @param word  Pointer to futex word
+ * @param count Max number of threads to wake
+ */
+static void CircularBuffer_futexWake( _Atomic u_int32_t * word, int count ) {
+    syscall( SYS_futex, (u_int32_t *) word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0 );
+}
+
+/**
+ * [PRIVATE] Copy kernel: libc (portable fallback)
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ */
+static void CircularBuffer_copyLibc( u_int8_t * dst, const u_int8_t * src, size_t n ) {
+    memcpy( dst, src, n );
+}
+
+#ifdef CIRCULARBUFFER_COPY_X86
+
+/**
+ * [PRIVATE] Copy kernel: SSE2 (16 byte vectors, 4x unrolled, overlapping last vector for the tail)
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ */
+__attribute__(( target( "sse2" ) ))
+static void CircularBuffer_copySSE2( u_int8_t * dst, const u_int8_t * src, size_t n ) {
+    if( n < 16 ) {
+        memcpy( dst, src, n );
+        return; //EARLY RETURN
+    }
+
+    const __m128i last = _mm_loadu_si128( (const __m128i *) ( src + n - 16 ) );
+    u_int8_t    * end  = ( dst + n - 16 );
+
+    for( ; n >= 64; n -= 64, dst += 64, src += 64 ) {
+        const __m128i a = _mm_loadu_si128( (const __m128i *) src );
+        const __m128i b = _mm_loadu_si128( (const __m128i *) ( src + 16 ) );
+        const __m128i c = _mm_loadu_si128( (const __m128i *) ( src + 32 ) );
+        const __m128i d = _mm_loadu_si128( (const __m128i *) ( src + 48 ) );
+
+        _mm_storeu_si128( (__m128i *) dst, a );
+        _mm_storeu_si128( (__m128i *) ( dst + 16 ), b );
+        _mm_storeu_si128( (__m128i *) ( dst + 32 ), c );
+        _mm_storeu_si128( (__m128i *) ( dst + 48 ), d );
+    }
+
+    for( ; n >= 16; n -= 16, dst += 16, src += 16 ) {
+        _mm_storeu_si128( (__m128i *) dst, _mm_loadu_si128( (const __m128i *) src ) );
+    }
+
+    _mm_storeu_si128( (__m128i *) end, last );
+}
+
+/**
+ * [PRIVATE] Copy kernel: AVX2 (32 byte vectors, 4x unrolled, overlapping last vector for the tail)
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ */
+__attribute__(( target( "avx2" ) ))
+static void CircularBuffer_copyAVX2( u_int8_t * dst, const u_int8_t * src, size_t n ) {
+    if( n < 32 ) {
+        CircularBuffer_copySSE2( dst, src, n );
+        return; //EARLY RETURN
+    }
+
+    const __m256i last = _mm256_loadu_si256( (const __m256i *) ( src + n - 32 ) );
+    u_int8_t    * end  = ( dst + n - 32 );
+
+    for( ; n >= 128; n -= 128, dst += 128, src += 128 ) {
+        const __m256i a = _mm256_loadu_si256( (const __m256i *) src );
+        const __m256i b = _mm256_loadu_si256( (const __m256i *) ( src + 32 ) );
+        const __m256i c = _mm256_loadu_si256( (const __m256i *) ( src + 64 ) );
+        const __m256i d = _mm256_loadu_si256( (const __m256i *) ( src + 96 ) );
+
+        _mm256_storeu_si256( (__m256i *) dst, a );
+        _mm256_storeu_si256( (__m256i *) ( dst + 32 ), b );
+        _mm256_storeu_si256( (__m256i *) ( dst + 64 ), c );
+        _mm256_storeu_si256( (__m256i *) ( dst + 96 ), d );
+    }
+
+    for( ; n >= 32; n -= 32, dst += 32, src += 32 ) {
+        _mm256_storeu_si256( (__m256i *) dst, _mm256_loadu_si256( (const __m256i *) src ) );
+    }
+
+    _mm256_storeu_si256( (__m256i *) end, last );
+}
+
+/**
+ * [PRIVATE] Copy kernel: AVX-512 (64 byte vectors, 4x unrolled, overlapping last vector for the tail)
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ */
+__attribute__(( target( "avx512f" ) ))
+static void CircularBuffer_copyAVX512( u_int8_t * dst, const u_int8_t * src, size_t n ) {
+    if( n < 64 ) {
+        CircularBuffer_copyAVX2( dst, src, n );
+        return; //EARLY RETURN
+    }
+
+    const __m512i last = _mm512_loadu_si512( (const void *) ( src + n - 64 ) );
+    u_int8_t    * end  = ( dst + n - 64 );
+
+    for( ; n >= 256; n -= 256, dst += 256, src += 256 ) {
+        const __m512i a = _mm512_loadu_si512( (const void *) src );
+        const __m512i b = _mm512_loadu_si512( (const void *) ( src + 64 ) );
+        const __m512i c = _mm512_loadu_si512( (const void *) ( src + 128 ) );
+        const __m512i d = _mm512_loadu_si512( (const void *) ( src + 192 ) );
+
+        _mm512_storeu_si512( (void *) dst, a );
+        _mm512_storeu_si512( (void *) ( dst + 64 ), b );
+        _mm512_storeu_si512( (void *) ( dst + 128 ), c );
+        _mm512_storeu_si512( (void *) ( dst + 192 ), d );
+    }
+
+    for( ; n >= 64; n -= 64, dst += 64, src += 64 ) {
+        _mm512_storeu_si512( (void *) dst, _mm512_loadu_si512( (const void *) src ) );
+    }
+
+    _mm512_storeu_si512( (void *) end, last );
+}
+
+#endif //CIRCULARBUFFER_COPY_X86
+
+/**
+ * [PRIVATE] CRC32C (Castagnoli, reflected) lookup table for the portable kernel
+ */
+static u_int32_t CircularBuffer_crcTable[256];
+
+/**
+ * [PRIVATE] Copy + CRC32C kernel: table driven (portable fallback)
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ * @param crc Running CRC32C (0 to start)
+ * @return Updated CRC32C
+ */
+static u_int32_t CircularBuffer_copyCrcTable( u_int8_t * dst, const u_int8_t * src, size_t n, u_int32_t crc ) {
+    crc = ~crc;
+
+    for( size_t i = 0; i < n; ++i ) {
+        dst[i] = src[i];
+        crc    = ( CircularBuffer_crcTable[( crc ^ src[i] ) & 0xFF] ^ ( crc >> 8 ) );
+    }
+
+    return ~crc;
+}
+
+#ifdef CIRCULARBUFFER_COPY_X86
+
+/**
+ * [PRIVATE] Copy + CRC32C kernel: SSE4.2 `crc32` instruction on each word as it is copied
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ * @param crc Running CRC32C (0 to start)
+ * @return Updated CRC32C
+ */
+__attribute__(( target( "sse4.2" ) ))
+static u_int32_t CircularBuffer_copyCrcSSE42( u_int8_t * dst, const u_int8_t * src, size_t n, u_int32_t crc ) {
+    crc = ~crc;
+
+#if defined( __x86_64__ )
+    u_int64_t crc64 = crc;
+
+    for( ; n >= 8; n -= 8, dst += 8, src += 8 ) {
+        u_int64_t word;
+
+        memcpy( &word, src, 8 );
+        memcpy( dst, &word, 8 );
+        crc64 = _mm_crc32_u64( crc64, word );
+    }
+
+    crc = (u_int32_t) crc64;
+#endif
+
+    for( ; n >= 4; n -= 4, dst += 4, src += 4 ) {
+        u_int32_t word;
+
+        memcpy( &word, src, 4 );
+        memcpy( dst, &word, 4 );
+        crc = _mm_crc32_u32( crc, word );
+    }
+
+    for( ; n > 0; --n, ++dst, ++src ) {
+        *dst = *src;
+        crc  = _mm_crc32_u8( crc, *src );
+    }
+
+    return ~crc;
+}
+
+#if defined( __x86_64__ )
+
+/**
+ * [PRIVATE] Lane lengths of the 3-way CRC32C kernel with their shift constants (see `CircularBuffer_selectCopyKernel(..)`):
+ * long lanes for the bulk of a chunk, short ones for its tail
+ * @param length Lane length in bytes
+ * @param shift1 x^(8 * length - 33) mod P: moves a lane's CRC past 1 lane
+ * @param shift2 x^(16 * length - 33) mod P: moves a lane's CRC past 2 lanes
+ */
+static struct {
+    size_t    length;
+    u_int32_t shift1;
+    u_int32_t shift2;
+} CircularBuffer_crcLanes[2] = { { 2048, 0, 0 }, { 256, 0, 0 } };
+
+/**
+ * [PRIVATE] Copy + CRC32C kernel: SSE4.2 `crc32` on 3 independent lanes at once (a single chain is bound by the
+ * instruction's 3 cycle latency) combined with PCLMUL carry-less multiplications
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ * @param crc Running CRC32C (0 to start)
+ * @return Updated CRC32C
+ */
+__attribute__(( target( "sse4.2,pclmul" ) ))
+static u_int32_t CircularBuffer_copyCrcPCLMUL( u_int8_t * dst, const u_int8_t * src, size_t n, u_int32_t crc ) {
+    u_int64_t crc0 = ~crc;
+
+    for( size_t l = 0; l < 2; ++l ) {
+        const size_t lane = CircularBuffer_crcLanes[l].length;
+
+        for( ; n >= ( 3 * lane ); n -= ( 3 * lane ), dst += ( 3 * lane ), src += ( 3 * lane ) ) {
+            u_int64_t crc1 = 0;
+            u_int64_t crc2 = 0;
+
+            for( size_t i = 0; i < lane; i += 8 ) {
+                u_int64_t word0, word1, word2;
+
+                memcpy( &word0, &src[i], 8 );
+                memcpy( &word1, &src[lane + i], 8 );
+                memcpy( &word2, &src[2 * lane + i], 8 );
+                memcpy( &dst[i], &word0, 8 );
+                memcpy( &dst[lane + i], &word1, 8 );
+                memcpy( &dst[2 * lane + i], &word2, 8 );
+                crc0 = _mm_crc32_u64( crc0, word0 );
+                crc1 = _mm_crc32_u64( crc1, word1 );
+                crc2 = _mm_crc32_u64( crc2, word2 );
+            }
+
+            //crc(A.B.C) = crc(A) * x^(2 * 8 * lane) + crc(B) * x^(8 * lane) + crc(C), the product reduced by `crc32`
+            const __m128i a = _mm_clmulepi64_si128( _mm_cvtsi64_si128( (long long) crc0 ), _mm_cvtsi32_si128( (int) CircularBuffer_crcLanes[l].shift2 ), 0 );
+            const __m128i b = _mm_clmulepi64_si128( _mm_cvtsi64_si128( (long long) crc1 ), _mm_cvtsi32_si128( (int) CircularBuffer_crcLanes[l].shift1 ), 0 );
+
+            crc0 = ( _mm_crc32_u64( 0, (u_int64_t) _mm_cvtsi128_si64( _mm_xor_si128( a, b ) ) ) ^ crc2 );
+        }
+    }
+
+    for( ; n >= 8; n -= 8, dst += 8, src += 8 ) {
+        u_int64_t word;
+
+        memcpy( &word, src, 8 );
+        memcpy( dst, &word, 8 );
+        crc0 = _mm_crc32_u64( crc0, word );
+    }
+
+    crc = (u_int32_t) crc0;
+
+    for( ; n > 0; --n, ++dst, ++src ) {
+        *dst = *src;
+        crc  = _mm_crc32_u8( crc, *src );
+    }
+
+    return ~crc;
+}
+
+/**
+ * [PRIVATE] Computes x^n modulo the CRC32C polynomial (reflected)
+ * @param n Power of x
+ * @return x^n mod P
+ */
+static u_int32_t CircularBuffer_crcPower( size_t n ) {
+    u_int32_t power = 0x80000000; //x^0
+
+    for( ; n > 0; --n ) {
+        power = ( ( power & 1 ) ? ( ( power >> 1 ) ^ 0x82F63B78 ) : ( power >> 1 ) );
+    }
+
+    return power;
+}
+
+#endif //__x86_64__
+
+#endif //CIRCULARBUFFER_COPY_X86
+
+/**
+ * [PRIVATE] Copy kernels by `CircularBuffer_Copy_e` (the ones the host CPU lacks stay NULL, see `CircularBuffer_selectCopyKernel(..)`)
+ */
+static struct {
+    const char * name;
+    void      (* copy)( u_int8_t * dst, const u_int8_t * src, size_t n );
+} CircularBuffer_copyKernels[] = {
+    [CIRCULARBUFFER_COPY_LIBC]   = { "libc", &CircularBuffer_copyLibc },
+    [CIRCULARBUFFER_COPY_AUTO]   = { "libc", &CircularBuffer_copyLibc },
+    [CIRCULARBUFFER_COPY_SSE2]   = { NULL, NULL },
+    [CIRCULARBUFFER_COPY_AVX2]   = { NULL, NULL },
+    [CIRCULARBUFFER_COPY_AVX512] = { NULL, NULL },
+};
+
+/**
+ * [PRIVATE] Copy + CRC32C kernel selected for the host CPU (see `CircularBuffer_selectCopyKernel(..)`)
+ */
+static struct {
+    const char * name;
+    u_int32_t (* copyCrc)( u_int8_t * dst, const u_int8_t * src, size_t n, u_int32_t crc );
+} CircularBuffer_crcKernel = { "table", &CircularBuffer_copyCrcTable };
+
+/**
+ * [PRIVATE] Once flag for the copy kernel selection
+ */
+static pthread_once_t CircularBuffer_copyKernelOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * [PRIVATE] Finds the copy kernels and the CRC32C kernel the host CPU supports (cpuid), AUTO being the widest one
+ */
+static void CircularBuffer_selectCopyKernel( void ) {
+    for( u_int32_t i = 0; i < 256; ++i ) {
+        u_int32_t crc = i;
+
+        for( int bit = 0; bit < 8; ++bit ) {
+            crc = ( ( crc & 1 ) ? ( ( crc >> 1 ) ^ 0x82F63B78 ) : ( crc >> 1 ) );
+        }
+
+        CircularBuffer_crcTable[i] = crc;
+    }
+
+#ifdef CIRCULARBUFFER_COPY_X86
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports( "sse4.2" ) ) {
+        CircularBuffer_crcKernel.name    = "sse4.2";
+        CircularBuffer_crcKernel.copyCrc = &CircularBuffer_copyCrcSSE42;
+    }
+
+#if defined( __x86_64__ )
+    if( __builtin_cpu_supports( "sse4.2" ) && __builtin_cpu_supports( "pclmul" ) ) {
+        for( size_t l = 0; l < 2; ++l ) {
+            CircularBuffer_crcLanes[l].shift1 = CircularBuffer_crcPower( 8 * CircularBuffer_crcLanes[l].length - 33 );
+            CircularBuffer_crcLanes[l].shift2 = CircularBuffer_crcPower( 16 * CircularBuffer_crcLanes[l].length - 33 );
+        }
+
+        CircularBuffer_crcKernel.name    = "sse4.2+pclmul";
+        CircularBuffer_crcKernel.copyCrc = &CircularBuffer_copyCrcPCLMUL;
+    }
+#endif
+
+    if( __builtin_cpu_supports( "sse2" ) ) {
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_SSE2].name = "sse2";
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_SSE2].copy = &CircularBuffer_copySSE2;
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AUTO]      = CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_SSE2];
+    }
+
+    if( __builtin_cpu_supports( "avx2" ) ) {
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AVX2].name = "avx2";
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AVX2].copy = &CircularBuffer_copyAVX2;
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AUTO]      = CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AVX2];
+    }
+
+    if( __builtin_cpu_supports( "avx512f" ) ) {
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AVX512].name = "avx512";
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AVX512].copy = &CircularBuffer_copyAVX512;
+        CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AUTO]        = CircularBuffer_copyKernels[CIRCULARBUFFER_COPY_AVX512];
+    }
+#endif
+}
+
+/**
+ * [PRIVATE] Copies with non-temporal stores that bypass the caches (SSE2, plain `memcpy` elsewhere)
+ * @param dst Destination
+ * @param src Source
+ * @param n   Length in bytes
+ */
+static void CircularBuffer_copyStream( u_int8_t * dst, const u_int8_t * src, size_t n ) {
+#if defined( __SSE2__ )
+    const size_t head = ( ( 16 - ( (size_t) dst & 15 ) ) & 15 ); //streaming stores need a 16 byte aligned destination
+
+    if( head >= n ) {
+        memcpy( dst, src, n );
+        return; //EARLY RETURN
+    }
+
+    memcpy( dst, src, head );
+    dst += head;
+    src += head;
+    n   -= head;
+
+    for( ; n >= 64; n -= 64, dst += 64, src += 64 ) {
+        const __m128i a = _mm_loadu_si128( (const __m128i *) src );
+        const __m128i b = _mm_loadu_si128( (const __m128i *) ( src + 16 ) );
+        const __m128i c = _mm_loadu_si128( (const __m128i *) ( src + 32 ) );
+        const __m128i d = _mm_loadu_si128( (const __m128i *) ( src + 48 ) );
+
+        _mm_stream_si128( (__m128i *) dst, a );
+        _mm_stream_si128( (__m128i *) ( dst + 16 ), b );
+        _mm_stream_si128( (__m128i *) ( dst + 32 ), c );
+        _mm_stream_si128( (__m128i *) ( dst + 48 ), d );
+    }
+
+    for( ; n >= 16; n -= 16, dst += 16, src += 16 ) {
+        _mm_stream_si128( (__m128i *) dst, _mm_loadu_si128( (const __m128i *) src ) );
+    }
+
+    memcpy( dst, src, n );
+    _mm_sfence(); //streaming stores are weakly ordered: drains them before the range gets published
+#else
+    memcpy( dst, src, n );
+#endif
+}
+
+/**
+ * [PRIVATE] Copies a chunk into the buffer (copy kernel, streamed past the caches from `options.stream_threshold` bytes)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param dst   Destination in the buffer
+ * @param src   Source
+ * @param n     Length in bytes
+ */
+static inline void CircularBuffer_copyIn( const CircularBuffer_t * cbuff, u_int8_t * dst, const u_int8_t * src, size_t n ) {
+    if( cbuff->options.stream_threshold > 0 && n >= cbuff->options.stream_threshold ) {
+        CircularBuffer_copyStream( dst, src, n );
+    } else {
+        CircularBuffer_copyKernels[cbuff->options.copy_kernel].copy( dst, src, n );
+    }
+}
+
+/**
+ * [PRIVATE] Copies a chunk out of the buffer (copy kernel)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param dst   Destination
+ * @param src   Source in the buffer
+ * @param n     Length in bytes
+ */
+static inline void CircularBuffer_copyOut( const CircularBuffer_t * cbuff, u_int8_t * dst, const u_int8_t * src, size_t n ) {
+    CircularBuffer_copyKernels[cbuff->options.copy_kernel].copy( dst, src, n );
+}
+
+/**
+ * [PRIVATE] Gets the offset of a cursor in the raw buffer
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param cursor Monotonic read/write cursor
+ * @return Offset (0 =< offset < size)
+ */
+static inline size_t CircularBuffer_offset( const CircularBuffer_t * cbuff, u_int64_t cursor ) {
+    return ( cbuff->mask ? (size_t) ( cursor & cbuff->mask ) : (size_t) ( cursor % cbuff->size ) );
+}
+
+/**
+ * [PRIVATE] Advance the read position (read position owner only)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param n     Number of bytes to advance position by
+ */
+static void CircularBuffer_advanceReadPos( CircularBuffer_t * cbuff, size_t n ) {
+    const u_int64_t read = atomic_load_explicit( &cbuff->position.read, memory_order_relaxed );
+
+    atomic_store_explicit( &cbuff->position.read, ( read + n ), memory_order_release );
+}
+
+/**
+ * [PRIVATE] Advance the write position (write position owner only)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param n     Number of bytes to advance position by
+ */
+static void CircularBuffer_advanceWritePos( CircularBuffer_t * cbuff, size_t n ) {
+    const u_int64_t write = atomic_load_explicit( &cbuff->position.write, memory_order_relaxed );
+
+    atomic_store_explicit( &cbuff->position.write, ( write + n ), memory_order_release );
+}
+
+/**
+ * [PRIVATE] Checks if at least `n` bytes are readable from a read cursor
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param cursor Read cursor
+ * @param n      Number of bytes
+ * @return Readable state
+ */
+static bool CircularBuffer_isReadable( CircularBuffer_t * cbuff, u_int64_t cursor, size_t n ) {
+    return ( (size_t) ( atomic_load_explicit( &cbuff->position.write, memory_order_acquire ) - cursor ) >= n );
+}
+
+/**
+ * [PRIVATE] Checks if at least `n` bytes are writable from a write cursor
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param cursor Write cursor
+ * @param n      Number of bytes
+ * @return Writable state
+ */
+static bool CircularBuffer_isWritable( CircularBuffer_t * cbuff, u_int64_t cursor, size_t n ) {
+    return ( ( cbuff->size - (size_t) ( cursor - atomic_load_explicit( &cbuff->position.read, memory_order_acquire ) ) ) >= n );
+}
+
+/**
+ * [PRIVATE] Checks if a side's claimed range is being filled/drained outside the mutex (LOCKED mode, mutex held)
+ * @param claim    Claim cursor of the side (moved past the position for the duration of the syscall)
+ * @param position Position cursor of the side
+ * @return Busy state
+ */
+static inline bool CircularBuffer_busy( _Atomic u_int64_t * claim, _Atomic u_int64_t * position ) {
+    return ( atomic_load_explicit( claim, memory_order_relaxed ) > atomic_load_explicit( position, memory_order_relaxed ) );
+}
+
+/**
+ * [PRIVATE] Hands a side back once its claimed range is done with and wakes the threads waiting on it (LOCKED mode, mutex held)
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param claim    Claim cursor of the side
+ * @param position Position cursor of the side
+ */
+static void CircularBuffer_release( CircularBuffer_t * cbuff, _Atomic u_int64_t * claim, _Atomic u_int64_t * position ) {
+    atomic_store_explicit( claim, atomic_load_explicit( position, memory_order_relaxed ), memory_order_relaxed );
+    pthread_cond_broadcast( &cbuff->ready ); //consumers, producers and resizes all wait on a busy side
+    pthread_cond_broadcast( &cbuff->space );
+}
+
+/**
+ * [PRIVATE] Moves the read position up to the slowest registered reader's cursor (BROADCAST mode)
+ * @param cbuff Pointer to CircularBuffer_t object
+ */
+static void CircularBuffer_updateTail( CircularBuffer_t * cbuff ) {
+    u_int64_t tail = atomic_load_explicit( &cbuff->position.write, memory_order_acquire ); //no readers: nothing to keep
+    u_int64_t read = atomic_load_explicit( &cbuff->position.read, memory_order_relaxed );
+
+    for( size_t i = 0; i < CIRCULARBUFFER_MAX_READERS; ++i ) {
+        if( atomic_load_explicit( &cbuff->readers[i].active, memory_order_acquire ) ) {
+            const u_int64_t cursor = atomic_load_explicit( &cbuff->readers[i].cursor, memory_order_acquire );
+
+            if( cursor < tail )
+                tail = cursor;
+        }
+    }
+
+    while( read < tail && !atomic_compare_exchange_weak_explicit( &cbuff->position.read, &read, tail, memory_order_release, memory_order_relaxed ) );
+}
+
+/**
+ * [PRIVATE] Wakes all threads parked on a parking spot if there are any (lock-free modes)
+ * @param cbuff   Pointer to CircularBuffer_t object
+ * @param parking Parking spot
+ * @param cond    Condition associated with the parking spot
+ */
+static void CircularBuffer_wake( CircularBuffer_t * cbuff, CircularBuffer_Parking_t * parking, pthread_cond_t * cond ) {
+    //pairs with the fence in `CircularBuffer_park(..)`: either the parked thread sees
+    //the new position or this sees the waiter count (and issues a wake-up)
+    atomic_thread_fence( memory_order_seq_cst );
+
+    if( atomic_load_explicit( &parking->waiters, memory_order_relaxed ) == 0 )
+        return; //EARLY RETURN
+
+    if( cbuff->options.wait.park == CIRCULARBUFFER_PARK_FUTEX ) {
+        atomic_fetch_add_explicit( &parking->futex, 1, memory_order_release );
+        CircularBuffer_futexWake( &parking->futex, INT_MAX );
+
+    } else {
+        pthread_mutex_lock( &cbuff->mutex );
+        pthread_cond_broadcast( cond );
+        pthread_mutex_unlock( &cbuff->mutex );
+    }
+}
+
+/**
+ * [PRIVATE] Wakes parked consumers, if any, once at least `options.wake_threshold` bytes are pending
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param write Write position just published
+ */
+static void CircularBuffer_wakeConsumers( CircularBuffer_t * cbuff, u_int64_t write ) {
+    if( cbuff->options.wake_threshold > 1 ) {
+        const size_t pending = (size_t) ( write - atomic_load_explicit( &cbuff->position.read, memory_order_acquire ) );
+
+        if( pending < cbuff->options.wake_threshold )
+            return; //EARLY RETURN
+    }
+
+    if( cbuff->options.mode != CIRCULARBUFFER_MODE_LOCKED ) {
+        CircularBuffer_wake( cbuff, &cbuff->parking.consumers, &cbuff->ready );
+
+    } else if( atomic_load_explicit( &cbuff->parking.consumers.waiters, memory_order_relaxed ) > 0 ) { //mutex held
+        pthread_cond_signal( &cbuff->ready );
+    }
+}
+
+/**
+ * [PRIVATE] Parks the calling thread until a predicate is satisfied (lock-free modes)
+ * @param cbuff     Pointer to CircularBuffer_t object
+ * @param parking   Parking spot
+ * @param cond      Condition associated with the parking spot
+ * @param predicate Predicate to satisfy
+ * @param cursor    Cursor to pass to the predicate
+ * @param n         Byte count to pass to the predicate
+ * @param deadline  Absolute CLOCK_MONOTONIC deadline (NULL for none)
+ * @return Predicate state
+ */
+static bool CircularBuffer_park( CircularBuffer_t * cbuff,
+                                 CircularBuffer_Parking_t * parking,
+                                 pthread_cond_t * cond,
+                                 bool (* predicate)( CircularBuffer_t *, u_int64_t, size_t ),
+                                 u_int64_t cursor,
+                                 size_t n,
+                                 const struct timespec * deadline )
+{
+    bool satisfied = false;
+    bool waiting   = true;
+
+    if( cbuff->options.wait.park == CIRCULARBUFFER_PARK_FUTEX ) {
+        atomic_fetch_add_explicit( &parking->waiters, 1, memory_order_relaxed );
+
+        while( waiting ) {
+            const u_int32_t futex = atomic_load_explicit( &parking->futex, memory_order_acquire );
+
+            atomic_thread_fence( memory_order_seq_cst );
+
+            if( ( satisfied = predicate( cbuff, cursor, n ) ) )
+                break;
+
+            waiting = CircularBuffer_futexWait( &parking->futex, futex, deadline );
+        }
+
+        atomic_fetch_sub_explicit( &parking->waiters, 1, memory_order_relaxed );
+
+    } else {
+        pthread_mutex_lock( &cbuff->mutex );
+        atomic_fetch_add_explicit( &parking->waiters, 1, memory_order_relaxed );
+        atomic_thread_fence( memory_order_seq_cst );
+
+        while( !( satisfied = predicate( cbuff, cursor, n ) ) && waiting ) {
+            waiting = CircularBuffer_condWait( cond, &cbuff->mutex, deadline );
+        }
+
+        atomic_fetch_sub_explicit( &parking->waiters, 1, memory_order_relaxed );
+        pthread_mutex_unlock( &cbuff->mutex );
+    }
+
+    return ( satisfied || predicate( cbuff, cursor, n ) );
+}
+
+/**
+ * [PRIVATE] Waits until a predicate is satisfied using the wait strategy (lock-free modes)
+ * @param cbuff     Pointer to CircularBuffer_t object
+ * @param parking   Parking spot
+ * @param cond      Condition associated with the parking spot
+ * @param predicate Predicate to satisfy
+ * @param cursor    Cursor to pass to the predicate
+ * @param n         Byte count to pass to the predicate
+ * @param deadline  Absolute CLOCK_MONOTONIC deadline (NULL for none)
+ * @return Predicate state
+ */
+static bool CircularBuffer_wait( CircularBuffer_t * cbuff,
+                                 CircularBuffer_Parking_t * parking,
+                                 pthread_cond_t * cond,
+                                 bool (* predicate)( CircularBuffer_t *, u_int64_t, size_t ),
+                                 u_int64_t cursor,
+                                 size_t n,
+                                 const struct timespec * deadline )
+{
+    for( unsigned i = 0; i < cbuff->options.wait.spins; ++i ) {
+        if( predicate( cbuff, cursor, n ) )
+            return true; //EARLY RETURN
+
+        CircularBuffer_cpuRelax();
+    }
+
+    for( unsigned i = 0; i < cbuff->options.wait.yields; ++i ) {
+        if( predicate( cbuff, cursor, n ) )
+            return true; //EARLY RETURN
+
+        sched_yield();
+    }
+
+    return CircularBuffer_park( cbuff, parking, cond, predicate, cursor, n, deadline );
+}
+
+/**
+ * [PRIVATE] Calculates the actual size of the buffer for a page size
+ * @param cbuff     Pointer to CircularBuffer_t object
+ * @param size      Required size
+ * @param page_size Page size (power of 2)
+ * @return Size rounded up to whole pages (and to a power of 2 with `options.power_of_two`)
+ */
+static size_t CircularBuffer_roundSize( const CircularBuffer_t * cbuff, size_t size, size_t page_size ) {
+    const size_t whole_pages = ( size / page_size ) + ( size % page_size > 0 ? 1 : 0 );
+    size_t       real_size   = whole_pages * page_size;
+
+    if( cbuff->options.power_of_two ) { //page size is a power of 2 so this stays page-aligned
+        size_t pow2_size = page_size;
+
+        while( pow2_size < real_size ) {
+            pow2_size <<= 1;
+        }
+
+        real_size = pow2_size;
+    }
+
+    fprintf( stderr,
+             "[CircularBuffer_roundSize( %p, %lu )] Calculated size: %lu bytes (page size: %lu bytes)\n",
+             cbuff, size, real_size, page_size
+    );
+
+    return real_size;
+}
+
+/**
+ * [PRIVATE] Maps the start of a raw buffer twice back to back at page size alignment (cleans up on failure)
+ * @param cbuff     Pointer to CircularBuffer_t object
+ * @param fd        Raw buffer file descriptor
+ * @param real_size Size of the raw buffer to map (whole pages)
+ * @param page_size Page size backing the raw buffer
+ * @return Virtual buffer (NULL on failure)
+ */
+static u_int8_t * CircularBuffer_mapMirror( CircularBuffer_t * cbuff, int fd, size_t real_size, size_t page_size ) {
+    const size_t slack    = ( page_size > (size_t) getpagesize() ? page_size : 0 ); //room to align on a huge page
+    u_int8_t   * reserved = NULL;
+    u_int8_t   * buffer   = NULL;
+
+    if( ( reserved = mmap( NULL, ( 2 * real_size + slack ), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) ) == MAP_FAILED ) {
+        fprintf( stderr,
+                 "[CircularBuffer_mapMirror( %p, %i, %lu, %lu )] Failed to map raw buffer: %s\n",
+                 cbuff, fd, real_size, page_size, strerror( errno )
+        );
+
+        return NULL; //EARLY RETURN
+    }
+
+    { //keeps only the aligned 2 sections of the reservation
+        const size_t head = ( ( page_size - ( (size_t) reserved & ( page_size - 1 ) ) ) & ( page_size - 1 ) );
+
+        buffer = ( reserved + head );
+
+        if( head > 0 )
+            munmap( reserved, head );
+        if( slack > head )
+            munmap( ( buffer + 2 * real_size ), ( slack - head ) );
+    }
+
+    if( mmap( buffer, real_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) == MAP_FAILED ) {
+        fprintf( stderr,
+                 "[CircularBuffer_mapMirror( %p, %i, %lu, %lu )] Failed to map virtual buffer section 1: %s\n",
+                 cbuff, fd, real_size, page_size, strerror( errno )
+        );
+
+        munmap( buffer, ( 2 * real_size ) );
+        return NULL; //EARLY RETURN
+    }
+
+    if( mmap( ( buffer + real_size ), real_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) == MAP_FAILED ) {
+        fprintf( stderr,
+                 "[CircularBuffer_mapMirror( %p, %i, %lu, %lu )] Failed to map virtual buffer section 2: %s\n",
+                 cbuff, fd, real_size, page_size, strerror( errno )
+        );
+
+        munmap( buffer, ( 2 * real_size ) );
+        return NULL; //EARLY RETURN
+    }
+
+    return buffer;
+}
+
+/**
+ * [PRIVATE] Creates the raw buffer and maps it twice back to back (cleans up on failure)
+ * @param cbuff     Pointer to CircularBuffer_t object
+ * @param real_size Size of the raw buffer (whole pages)
+ * @param page_size Page size backing the raw buffer
+ * @param flags     memfd flags (MFD_HUGETLB and its page size for huge pages)
+ * @return Success
+ */
+static bool CircularBuffer_createMirror( CircularBuffer_t * cbuff, size_t real_size, size_t page_size, unsigned int flags ) {
+    u_int8_t * buffer = NULL;
+
+    if( ( cbuff->fd = CircularBuffer_memfd_create( "circular_buffer", flags ) ) < 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_createMirror( %p, %lu, %lu, %u )] Failed to create raw buffer file descriptor: %s\n",
+                 cbuff, real_size, page_size, flags, strerror( errno )
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( ftruncate( cbuff->fd, real_size ) < 0 ) { //truncate a file to a specified length
+        fprintf( stderr,
+                 "[CircularBuffer_createMirror( %p, %lu, %lu, %u )] Failed to adjust raw buffer size: %s\n",
+                 cbuff, real_size, page_size, flags, strerror( errno )
+        );
+
+        close( cbuff->fd );
+        return false; //EARLY RETURN
+    }
+
+    if( ( buffer = CircularBuffer_mapMirror( cbuff, cbuff->fd, real_size, page_size ) ) == NULL ) {
+        close( cbuff->fd );
+        return false; //EARLY RETURN
+    }
+
+    cbuff->buffer    = buffer;
+    cbuff->page_size = page_size;
+
+    return true;
+}
+
+/**
+ * [PRIVATE] Gets the NUMA node of a CPU
+ * @param cpu CPU number (-1 for the calling thread's CPU)
+ * @return Node number (-1 on failure)
+ */
+static int CircularBuffer_cpuNode( int cpu ) {
+    unsigned int current = 0;
+    unsigned int node    = 0;
+    char         path[64];
+    DIR        * dir     = NULL;
+    int          found   = -1;
+
+    if( cpu < 0 ) {
+        return ( syscall( __NR_getcpu, &current, &node, NULL ) == 0 ? (int) node : -1 ); //EARLY RETURN
+    }
+
+    snprintf( path, sizeof( path ), "/sys/devices/system/cpu/cpu%d", cpu );
+
+    if( ( dir = opendir( path ) ) != NULL ) { //holds a `node<N>` link to its node
+        struct dirent * entry = NULL;
+
+        while( found < 0 && ( entry = readdir( dir ) ) != NULL ) {
+            if( strncmp( entry->d_name, "node", 4 ) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9' )
+                found = atoi( &entry->d_name[4] );
+        }
+
+        closedir( dir );
+    }
+
+    return found;
+}
+
+/**
+ * [PRIVATE] Applies the NUMA placement policy to the buffer's pages (shared policy of the memfd, before first touch)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param buffer Virtual buffer
+ * @param size   Size of the raw buffer
+ * @return Success
+ */
+static bool CircularBuffer_applyNumaPolicy( CircularBuffer_t * cbuff, u_int8_t * buffer, size_t size ) {
+    unsigned long nodes[16] = { 0 }; //up to 1024 nodes
+    const int     max_node  = (int) ( sizeof( nodes ) * CHAR_BIT );
+    int           mode      = MPOL_DEFAULT;
+
+    cbuff->numa_node = -1;
+
+    if( cbuff->options.numa == CIRCULARBUFFER_NUMA_BIND ) {
+        const int node = CircularBuffer_cpuNode( cbuff->options.numa_cpu );
+
+        if( node < 0 || node >= max_node ) {
+            fprintf( stderr,
+                     "[CircularBuffer_applyNumaPolicy( %p )] Failed to find the node of CPU %d.\n",
+                     cbuff, cbuff->options.numa_cpu
+            );
+
+            return false; //EARLY RETURN
+        }
+
+        nodes[node / ( sizeof( unsigned long ) * CHAR_BIT )] |= ( 1UL << ( node % ( sizeof( unsigned long ) * CHAR_BIT ) ) );
+        mode             = MPOL_BIND;
+        cbuff->numa_node = node;
+
+    } else if( cbuff->options.numa == CIRCULARBUFFER_NUMA_INTERLEAVE ) {
+        FILE * online = fopen( "/sys/devices/system/node/online", "r" ); //e.g. "0-1,3"
+        int    first  = 0;
+        int    last   = 0;
+        char   sep    = 0;
+
+        if( online == NULL ) {
+            nodes[0] = 1UL;
+
+        } else {
+            while( fscanf( online, "%d", &first ) == 1 ) {
+                last = first;
+
+                if( ( sep = (char) fgetc( online ) ) == '-' && fscanf( online, "%d", &last ) == 1 )
+                    sep = (char) fgetc( online );
+
+                for( int node = first; node <= last && node < max_node; ++node ) {
+                    nodes[node / ( sizeof( unsigned long ) * CHAR_BIT )] |= ( 1UL << ( node % ( sizeof( unsigned long ) * CHAR_BIT ) ) );
+                }
+
+                if( sep != ',' )
+                    break;
+            }
+
+            fclose( online );
+        }
+
+        mode = MPOL_INTERLEAVE;
+
+    } else {
+        return true; //EARLY RETURN
+    }
+
+    //the policy of a shared mapping is held by the memfd itself so it also covers section 2
+    if( syscall( __NR_mbind, buffer, size, mode, nodes, (unsigned long) max_node, 0 ) != 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_applyNumaPolicy( %p )] Failed to apply NUMA policy %d: %s\n",
+                 cbuff, cbuff->options.numa, strerror( errno )
+        );
+
+        cbuff->numa_node = -1;
+        return false; //EARLY RETURN
+    }
+
+    return true;
+}
+
+/**
+ * [PRIVATE] Makes the buffer resident before any traffic: prefaults its pages and/or locks them in memory
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param buffer Virtual buffer
+ * @param size   Size of the raw buffer
+ * @param fresh  Offset from which the raw buffer holds no data yet (the only pages touched when populating is not supported)
+ */
+static void CircularBuffer_makeResident( CircularBuffer_t * cbuff, u_int8_t * buffer, size_t size, size_t fresh ) {
+    const size_t length = ( 2 * size ); //both sections so that neither takes a (minor) fault on the first lap
+
+    if( cbuff->options.prefault && madvise( buffer, length, MADV_POPULATE_WRITE ) != 0 ) { //Linux < 5.14: touches every page
+        for( size_t i = fresh; i < size; i += cbuff->page_size ) {
+            ( (volatile u_int8_t *) buffer )[i]        = 0;
+            ( (volatile u_int8_t *) buffer )[size + i] = 0;
+        }
+    }
+
+    if( cbuff->options.lock_pages && mlock( buffer, length ) != 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_makeResident( %p, %p, %lu, %lu )] Failed to lock the pages in memory: %s\n",
+                 cbuff, buffer, size, fresh, strerror( errno )
+        );
+    }
+}
+
+/**
+ * [PRIVATE] Gets the current coarse CLOCK_MONOTONIC time (ms resolution, cheap enough for every consumer call)
+ * @return Time in ns
+ */
+static u_int64_t CircularBuffer_now( void ) {
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC_COARSE, &now );
+
+    return ( (u_int64_t) now.tv_sec * 1000000000 + (u_int64_t) now.tv_nsec );
+}
+
+/**
+ * Initialises a circular buffer
+ * @return Circular buffer object
+ */
+static CircularBuffer_t CircularBuffer_create( void ) {
+    return (CircularBuffer_t) {
+        .fd          = 0,
+        .buffer      = NULL,
+        .size        = 0,
+        .mask        = 0,
+        .page_size   = 0,
+        .numa_node   = -1,
+        .trimmed     = 0,
+        .trim_mark   = 0,
+        .mutex       = PTHREAD_MUTEX_INITIALIZER,
+        .ready       = PTHREAD_COND_INITIALIZER,
+        .space       = PTHREAD_COND_INITIALIZER,
+        .options     = {
+            .mode             = CIRCULARBUFFER_MODE_LOCKED,
+            .power_of_two     = false,
+            .blocking_write   = false,
+            .wake_threshold   = 0,
+            .wait             = { .spins = 0, .yields = 0, .park = CIRCULARBUFFER_PARK_CONDITION },
+            .stream_threshold = 0,
+            .copy_kernel      = CIRCULARBUFFER_COPY_LIBC,
+            .huge_page_size   = 0,
+            .numa             = CIRCULARBUFFER_NUMA_NONE,
+            .numa_cpu         = -1,
+            .prefault         = false,
+            .lock_pages       = false,
+            .resizable        = false,
+            .trim_keep        = 0,
+            .trim_interval    = 0,
+        },
+        .parking     = { .consumers = { 0, 0 }, .producers = { 0, 0 } },
+        .position    = { 0, 0, 0, 0 },
+        .readers     = { { 0, false } },
+        .gate        = { false, 0, 0, 0, 0, 0 },
+        .engine      = { NULL, NULL },
+    };
+}
+
+/**
+ * [THREAD-SAFE] Initialises the circular buffer
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param size  Required size for buffer
+ * @return Success
+ */
+static bool CircularBuffer_init( CircularBuffer_t * cbuff, size_t size ) {
+    /*
+     * raw buffer (fd): [##########]
+     *                   |        |
+     *                   |<------>| (n * page size)
+     *                   |        |
+     *  virtual buffer: [##########|##########]
+     *                   ^        ^ ^        ^
+     *                   0        n 0        n
+     *                   |          |
+     *                   section 1  section 2
+     */
+    bool   error_state = false;
+    size_t real_size   = size;
+
+    if( cbuff == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_init( %p, %lu )] CircularBuffer_t is NULL.\n",
+                 cbuff, size
+        );
+
+        error_state = true;
+        goto end;
+    }
+
+    pthread_once( &CircularBuffer_copyKernelOnce, CircularBuffer_selectCopyKernel );
+    pthread_mutex_lock( &cbuff->mutex );
+
+    if( (unsigned) cbuff->options.copy_kernel > CIRCULARBUFFER_COPY_AVX512 || CircularBuffer_copyKernels[cbuff->options.copy_kernel].copy == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_init( %p, %lu )] Copy kernel %d unknown or not supported by the CPU: falling back to libc.\n",
+                 cbuff, size, cbuff->options.copy_kernel
+        );
+
+        cbuff->options.copy_kernel = CIRCULARBUFFER_COPY_LIBC;
+    }
+
+    if( size < 1 || size > LONG_MAX ) {
+        fprintf( stderr,
+                 "[CircularBuffer_init( %p, %lu )] Bad size (0 > size =< %lu).\n",
+                 cbuff, size, size, LONG_MAX
+        );
+
+        error_state = true;
+        goto end;
+    }
+
+    if( cbuff->options.huge_page_size > 0
+     && ( ( cbuff->options.huge_page_size & ( cbuff->options.huge_page_size - 1 ) ) != 0 || cbuff->options.huge_page_size <= (size_t) getpagesize() ) )
+    {
+        fprintf( stderr,
+                 "[CircularBuffer_init( %p, %lu )] Bad huge page size (%lu): not a power of 2 above the page size (%i).\n",
+                 cbuff, size, cbuff->options.huge_page_size, getpagesize()
+        );
+
+        error_state = true;
+        goto end;
+    }
+
+    bool mapped = false;
+
+    if( cbuff->options.huge_page_size > 0 ) {
+        const unsigned int huge_log2 = (unsigned int) __builtin_ctzl( cbuff->options.huge_page_size );
+
+        real_size = CircularBuffer_roundSize( cbuff, size, cbuff->options.huge_page_size );
+        mapped    = CircularBuffer_createMirror( cbuff, real_size, cbuff->options.huge_page_size, ( MFD_HUGETLB | ( huge_log2 << MFD_HUGE_SHIFT ) ) );
+
+        if( !mapped ) {
+            fprintf( stderr,
+                     "[CircularBuffer_init( %p, %lu )] Huge pages (%lu bytes) unavailable: falling back to %i byte pages.\n",
+                     cbuff, size, cbuff->options.huge_page_size, getpagesize()
+            );
+        }
+    }
+
+    if( !mapped ) {
+        real_size = CircularBuffer_roundSize( cbuff, size, (size_t) getpagesize() );
+
+        if( !CircularBuffer_createMirror( cbuff, real_size, (size_t) getpagesize(), 0 ) ) {
+            error_state = true;
+            goto end;
+        }
+    }
+
+    { //conditions wait on CLOCK_MONOTONIC so that deadlines match the futex ones
+        pthread_condattr_t attr;
+
+        pthread_condattr_init( &attr );
+        pthread_condattr_setclock( &attr, CLOCK_MONOTONIC );
+        pthread_cond_destroy( &cbuff->ready );
+        pthread_cond_destroy( &cbuff->space );
+        pthread_cond_init( &cbuff->ready, &attr );
+        pthread_cond_init( &cbuff->space, &attr );
+        pthread_condattr_destroy( &attr );
+    }
+
+    cbuff->size = real_size;
+    cbuff->mask = ( cbuff->options.power_of_two ? ( real_size - 1 ) : 0 );
+
+    if( !CircularBuffer_applyNumaPolicy( cbuff, cbuff->buffer, real_size ) ) { //placement is an optimisation: the buffer stays usable without it
+        fprintf( stderr,
+                 "[CircularBuffer_init( %p, %lu )] NUMA policy not applied: pages land on first touch.\n",
+                 cbuff, size
+        );
+    }
+
+    CircularBuffer_makeResident( cbuff, cbuff->buffer, real_size, 0 ); //after the NUMA policy so the pages land where it says
+
+    if( cbuff->options.wake_threshold > real_size ) { //a full buffer must always wake its consumers
+        cbuff->options.wake_threshold = real_size;
+    }
+    atomic_store( &cbuff->position.write, 0 );
+    atomic_store( &cbuff->position.read, 0 );
+    atomic_store( &cbuff->position.write_claim, 0 );
+    atomic_store( &cbuff->position.read_claim, 0 );
+    atomic_store( &cbuff->trimmed, CircularBuffer_now() );
+    atomic_store( &cbuff->trim_mark, 0 );
+
+    end:
+        pthread_mutex_unlock( &cbuff->mutex );
+        return !( error_state );
+}
+
+/**
+ * [PRIVATE] Checks if operations go through the resize gate (lock-free modes with `options.resizable`)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @return Gated state
+ */
+static inline bool CircularBuffer_gated( const CircularBuffer_t * cbuff ) {
+    return ( cbuff->options.resizable && cbuff->options.mode != CIRCULARBUFFER_MODE_LOCKED );
+}
+
+/**
+ * [PRIVATE] Checks an operation in through the resize gate, waiting out a swap in progress (spins, then parks on the gate)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param side  In-flight counter of the operation's side
+ */
+static void CircularBuffer_enterGate( CircularBuffer_t * cbuff, _Atomic u_int32_t * side ) {
+    if( !CircularBuffer_gated( cbuff ) )
+        return; //EARLY RETURN
+
+    for( ;; ) { //pairs with `CircularBuffer_closeGate(..)`: either the swap sees the count or this sees the gate closed
+        atomic_fetch_add_explicit( side, 1, memory_order_seq_cst );
+
+        if( !atomic_load_explicit( &cbuff->gate.closed, memory_order_seq_cst ) )
+            return; //EARLY RETURN
+
+        atomic_fetch_sub_explicit( side, 1, memory_order_release );
+
+        for( unsigned i = 0; atomic_load_explicit( &cbuff->gate.closed, memory_order_acquire ); ++i ) {
+            if( i < cbuff->options.wait.spins ) {
+                CircularBuffer_cpuRelax();
+            } else { //pairs with `CircularBuffer_openGate(..)`: either the wait sees the gate open or the swap sees the waiter
+                atomic_fetch_add_explicit( &cbuff->gate.waiters, 1, memory_order_seq_cst );
+                CircularBuffer_futexWait( &cbuff->gate.closed, 1, NULL );
+                atomic_fetch_sub_explicit( &cbuff->gate.waiters, 1, memory_order_relaxed );
+            }
+        }
+    }
+}
+
+/**
+ * [PRIVATE] Checks an operation out through the resize gate
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param side  In-flight counter of the operation's side
+ */
+static inline void CircularBuffer_leaveGate( CircularBuffer_t * cbuff, _Atomic u_int32_t * side ) {
+    if( CircularBuffer_gated( cbuff ) )
+        atomic_fetch_sub_explicit( side, 1, memory_order_release );
+}
+
+/**
+ * [PRIVATE] Pins the mapping and checks an operation out through the resize gate ahead of a syscall that can block on
+ * its range: resize/trim refuse while the mapping is pinned rather than wait for the syscall with the gate closed
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param side  In-flight counter of the operation's side
+ */
+static inline void CircularBuffer_pin( CircularBuffer_t * cbuff, _Atomic u_int32_t * side ) {
+    if( CircularBuffer_gated( cbuff ) ) { //pinned first: a swap waiting for the count to drop sees the pin
+        atomic_fetch_add_explicit( &cbuff->gate.pinned, 1, memory_order_seq_cst );
+        atomic_fetch_sub_explicit( side, 1, memory_order_release );
+    }
+}
+
+/**
+ * [PRIVATE] Unpins the mapping pinned by `CircularBuffer_pin(..)` once the range is published
+ * @param cbuff Pointer to CircularBuffer_t object
+ */
+static inline void CircularBuffer_unpin( CircularBuffer_t * cbuff ) {
+    if( CircularBuffer_gated( cbuff ) )
+        atomic_fetch_sub_explicit( &cbuff->gate.pinned, 1, memory_order_release );
+}
+
+/**
+ * [PRIVATE] Closes the resize gate and waits for the operations in flight to check out
+ * @param cbuff Pointer to CircularBuffer_t object
+ */
+static void CircularBuffer_closeGate( CircularBuffer_t * cbuff ) {
+    atomic_store_explicit( &cbuff->gate.closed, 1, memory_order_seq_cst );
+
+    if( !CircularBuffer_gated( cbuff ) )
+        return; //EARLY RETURN
+
+    for( unsigned i = 0; atomic_load_explicit( &cbuff->gate.producers, memory_order_seq_cst ) > 0
+                      || atomic_load_explicit( &cbuff->gate.consumers, memory_order_seq_cst ) > 0; ++i )
+    {
+        if( i < cbuff->options.wait.spins ) {
+            CircularBuffer_cpuRelax();
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * [PRIVATE] Opens the resize gate and wakes the operations parked on it
+ * @param cbuff Pointer to CircularBuffer_t object
+ */
+static void CircularBuffer_openGate( CircularBuffer_t * cbuff ) {
+    atomic_store_explicit( &cbuff->gate.closed, 0, memory_order_seq_cst );
+
+    if( atomic_load_explicit( &cbuff->gate.waiters, memory_order_seq_cst ) > 0 )
+        CircularBuffer_futexWake( &cbuff->gate.closed, INT_MAX );
+}
+
+/**
+ * [THREAD-SAFE] Grows the buffer in use without losing its content
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param size  New required size for buffer (> current size)
+ * @return Success
+ */
+static bool CircularBuffer_resize( CircularBuffer_t * cbuff, size_t size ) {
+    /*
+     * old raw buffer (fd): [BBB....AAAA]           readable range wrapped: A from the read position then B
+     *                       0      ^    ^
+     *                              r    old size
+     *
+     * new raw buffer (fd): [.......AAAABBB....]    fd grown in place: A stays put, B moves after it and the cursors
+     *                       0      ^    ^     ^    are rebased so that the read position still lands on `r`
+     *                              r    old   new size
+     */
+    bool error_state = false;
+    bool expected    = false;
+
+    if( cbuff == NULL || cbuff->buffer == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] CircularBuffer_t is NULL or not initialised.\n",
+                 cbuff, size
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( cbuff->options.mode != CIRCULARBUFFER_MODE_LOCKED && !cbuff->options.resizable ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] Lock-free mode buffers are only resizable with `options.resizable`.\n",
+                 cbuff, size
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( CircularBuffer_writeReservation.cbuff == cbuff || CircularBuffer_readReservation.cbuff == cbuff ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] A reservation is pending on this thread.\n",
+                 cbuff, size
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( size <= cbuff->size || size > LONG_MAX ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] Bad size (%lu < size =< %lu).\n",
+                 cbuff, size, cbuff->size, LONG_MAX
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( !atomic_compare_exchange_strong( &cbuff->gate.resizing, &expected, true ) ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] Already being resized.\n",
+                 cbuff, size
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    //everything up to the swap runs alongside the traffic: the current mapping only covers the start of the fd
+    const bool   locked    = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    const size_t old_size  = cbuff->size;
+    const size_t real_size = CircularBuffer_roundSize( cbuff, size, cbuff->page_size );
+    u_int8_t   * buffer    = NULL;
+
+    if( ftruncate( cbuff->fd, real_size ) < 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] Failed to adjust raw buffer size: %s\n",
+                 cbuff, size, strerror( errno )
+        );
+
+        error_state = true;
+        goto end;
+    }
+
+    if( ( buffer = CircularBuffer_mapMirror( cbuff, cbuff->fd, real_size, cbuff->page_size ) ) == NULL ) {
+        ftruncate( cbuff->fd, old_size );
+        error_state = true;
+        goto end;
+    }
+
+    if( !CircularBuffer_applyNumaPolicy( cbuff, buffer, real_size ) ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] NUMA policy not applied: pages land on first touch.\n",
+                 cbuff, size
+        );
+    }
+
+    CircularBuffer_makeResident( cbuff, buffer, real_size, old_size );
+
+    CircularBuffer_closeGate( cbuff );
+    pthread_mutex_lock( &cbuff->mutex );
+
+    if( locked ) { //a range is filled/drained outside the mutex: the old mapping is in use until it is handed back
+        atomic_fetch_add_explicit( &cbuff->parking.producers.waiters, 1, memory_order_relaxed );
+
+        while( CircularBuffer_busy( &cbuff->position.write_claim, &cbuff->position.write )
+            || CircularBuffer_busy( &cbuff->position.read_claim, &cbuff->position.read ) )
+        {
+            CircularBuffer_condWait( &cbuff->space, &cbuff->mutex, NULL );
+        }
+
+        atomic_fetch_sub_explicit( &cbuff->parking.producers.waiters, 1, memory_order_relaxed );
+    }
+
+    if( atomic_load( &cbuff->gate.pinned ) > 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_resize( %p, %lu )] Mapping pinned by an io_uring engine or a file descriptor transfer.\n",
+                 cbuff, size
+        );
+
+        munmap( buffer, ( 2 * real_size ) );
+        ftruncate( cbuff->fd, old_size );
+        error_state = true;
+
+    } else {
+        const u_int64_t read    = atomic_load_explicit( &cbuff->position.read, memory_order_relaxed );
+        const size_t    used    = (size_t) ( atomic_load_explicit( &cbuff->position.write, memory_order_relaxed ) - read );
+        const size_t    head    = CircularBuffer_offset( cbuff, read );
+        const size_t    wrapped = ( head + used > old_size ? ( head + used - old_size ) : 0 ); //B
+        const size_t    moved   = ( wrapped < ( real_size - old_size ) ? wrapped : ( real_size - old_size ) );
+
+        memcpy( &buffer[old_size], buffer, moved );
+
+        if( wrapped > moved ) //B wraps in the new raw buffer too
+            memmove( buffer, &buffer[moved], ( wrapped - moved ) );
+
+        if( munmap( cbuff->buffer, ( 2 * old_size ) ) != 0 ) {
+            fprintf( stderr,
+                     "[CircularBuffer_resize( %p, %lu )] Failed unmap previous virtual buffer: %s\n",
+                     cbuff, size, strerror( errno )
+            );
+        }
+
+        cbuff->buffer = buffer;
+        cbuff->size   = real_size;
+        cbuff->mask   = ( cbuff->options.power_of_two ? ( real_size - 1 ) : 0 );
+
+        const u_int64_t shift = ( ( head + real_size - CircularBuffer_offset( cbuff, read ) ) % real_size );
+
+        atomic_fetch_add( &cbuff->position.write, shift ); //write side first so that occupancy is never negative
+        atomic_fetch_add( &cbuff->position.write_claim, shift );
+        atomic_fetch_add( &cbuff->position.read_claim, shift );
+        atomic_fetch_add( &cbuff->position.read, shift );
+
+        for( size_t i = 0; i < CIRCULARBUFFER_MAX_READERS; ++i ) {
+            atomic_fetch_add( &cbuff->readers[i].cursor, shift );
+        }
+    }
+
+    CircularBuffer_openGate( cbuff );
+
+    if( locked ) {
+        pthread_cond_broadcast( &cbuff->ready );
+        pthread_cond_broadcast( &cbuff->space );
+    }
+
+    pthread_mutex_unlock( &cbuff->mutex );
+
+    if( !locked ) { //parked threads re-check against the new size
+        CircularBuffer_wake( cbuff, &cbuff->parking.consumers, &cbuff->ready );
+        CircularBuffer_wake( cbuff, &cbuff->parking.producers, &cbuff->space );
+    }
+
+    end:
+        atomic_store( &cbuff->gate.resizing, false );
+        return !( error_state );
+}
+
+/**
+ * [PRIVATE] Releases the pages of a range of the raw buffer
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param offset Start of the range (page aligned)
+ * @param length Length of the range in bytes (whole pages)
+ * @return Success
+ */
+static bool CircularBuffer_punch( CircularBuffer_t * cbuff, size_t offset, size_t length ) {
+    if( CircularBuffer_fallocate( cbuff->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t) offset, (off_t) length ) == 0 )
+        return true; //EARLY RETURN
+
+    return ( madvise( &cbuff->buffer[offset], length, MADV_REMOVE ) == 0 ); //fallocate(2) not supported
+}
+
+/**
+ * [PRIVATE] Checks the buffer's pages can be released (resize gate available and no residency asked for)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @return Trimmable state
+ */
+static inline bool CircularBuffer_trimmable( const CircularBuffer_t * cbuff ) {
+    return ( ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED || cbuff->options.resizable )
+          && !cbuff->options.prefault && !cbuff->options.lock_pages );
+}
+
+/**
+ * [THREAD-SAFE] Releases the pages of the free range of the buffer
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @return Success
+ */
+static bool CircularBuffer_trim( CircularBuffer_t * cbuff ) {
+    bool error_state = false;
+    bool expected    = false;
+
+    if( cbuff == NULL || cbuff->buffer == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_trim( %p )] CircularBuffer_t is NULL or not initialised.\n",
+                 cbuff
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( !CircularBuffer_trimmable( cbuff ) ) {
+        fprintf( stderr,
+                 "[CircularBuffer_trim( %p )] Lock-free mode buffers are only trimmed with `options.resizable`, never with `options.prefault` or `options.lock_pages`.\n",
+                 cbuff
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( CircularBuffer_writeReservation.cbuff == cbuff || CircularBuffer_readReservation.cbuff == cbuff ) {
+        fprintf( stderr,
+                 "[CircularBuffer_trim( %p )] A reservation is pending on this thread.\n",
+                 cbuff
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    if( !atomic_compare_exchange_strong( &cbuff->gate.resizing, &expected, true ) ) {
+        fprintf( stderr,
+                 "[CircularBuffer_trim( %p )] Being resized or trimmed already.\n",
+                 cbuff
+        );
+
+        return false; //EARLY RETURN
+    }
+
+    CircularBuffer_closeGate( cbuff ); //producers write into the free range
+    pthread_mutex_lock( &cbuff->mutex );
+
+    if( atomic_load( &cbuff->gate.pinned ) > 0 ) { //an io_uring read or writeFromFd/spliceFromPipe in flight fills the free range
+        fprintf( stderr,
+                 "[CircularBuffer_trim( %p )] Mapping pinned by an io_uring engine or a file descriptor transfer.\n",
+                 cbuff
+        );
+
+        error_state = true;
+
+    } else { //whole pages of the free range [write + keep, read + size)
+        const u_int64_t page  = cbuff->page_size; //size is whole pages so cursors and offsets share page boundaries
+        const u_int64_t read  = atomic_load_explicit( &cbuff->position.read, memory_order_relaxed );
+        const u_int64_t write = atomic_load_explicit( &cbuff->position.write, memory_order_relaxed );
+        const u_int64_t claim = atomic_load_explicit( &cbuff->position.write_claim, memory_order_relaxed );
+        const u_int64_t fill  = ( claim > write ? claim : write ); //LOCKED mode: range being filled outside the mutex
+        const u_int64_t start = ( ( fill + cbuff->options.trim_keep + page - 1 ) / page * page );
+        const u_int64_t end   = ( ( read + cbuff->size ) / page * page );
+
+        if( end > start ) {
+            const size_t offset = CircularBuffer_offset( cbuff, start );
+            const size_t length = (size_t) ( end - start );
+            const size_t first  = ( length < ( cbuff->size - offset ) ? length : ( cbuff->size - offset ) );
+
+            if( !CircularBuffer_punch( cbuff, offset, first ) || ( length > first && !CircularBuffer_punch( cbuff, 0, ( length - first ) ) ) ) {
+                fprintf( stderr,
+                         "[CircularBuffer_trim( %p )] Failed to release the pages (%lu bytes): %s\n",
+                         cbuff, length, strerror( errno )
+                );
+
+                error_state = true;
+            }
+        }
+
+        atomic_store_explicit( &cbuff->trimmed, CircularBuffer_now(), memory_order_relaxed );
+        atomic_store_explicit( &cbuff->trim_mark, write, memory_order_relaxed );
+    }
+
+    CircularBuffer_openGate( cbuff );
+    pthread_mutex_unlock( &cbuff->mutex );
+    atomic_store( &cbuff->gate.resizing, false );
+
+    return !( error_state );
+}
+
+/**
+ * [PRIVATE] Trims the buffer once it went idle: no more than `options.trim_keep` bytes published over a whole
+ * `options.trim_interval` (checked by consumer calls, gate left). Busy buffers keep their pages however often they drain.
+ * @param cbuff Pointer to CircularBuffer_t object
+ */
+static void CircularBuffer_idleTrim( CircularBuffer_t * cbuff ) {
+    if( cbuff->options.trim_interval == 0 || !CircularBuffer_trimmable( cbuff ) || atomic_load( &cbuff->gate.pinned ) > 0 )
+        return; //EARLY RETURN
+
+    const u_int64_t now  = CircularBuffer_now();
+    u_int64_t       last = atomic_load_explicit( &cbuff->trimmed, memory_order_relaxed );
+
+    //the window start is moved on first so that only one of concurrent consumers closes the window
+    if( ( now - last ) < (u_int64_t) cbuff->options.trim_interval * 1000000
+     || !atomic_compare_exchange_strong_explicit( &cbuff->trimmed, &last, now, memory_order_relaxed, memory_order_relaxed ) )
+    {
+        return; //EARLY RETURN
+    }
+
+    const u_int64_t write = atomic_load_explicit( &cbuff->position.write, memory_order_relaxed );
+    const u_int64_t mark  = atomic_exchange_explicit( &cbuff->trim_mark, write, memory_order_relaxed );
+
+    if( ( write - mark ) <= cbuff->options.trim_keep )
+        CircularBuffer_trim( cbuff );
+}
+
+/**
+ * [PRIVATE] Waits for all the claims preceding a cursor to be published (shared cursor modes)
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param position Published position
+ * @param cursor   Start cursor of the claim waiting to be published
+ */
+static void CircularBuffer_awaitTurn( CircularBuffer_t * cbuff, _Atomic u_int64_t * position, u_int64_t cursor ) {
+    for( unsigned i = 0; atomic_load_explicit( position, memory_order_acquire ) != cursor; ++i ) {
+        if( i < cbuff->options.wait.spins ) {
+            CircularBuffer_cpuRelax();
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * [PRIVATE] Claims a range of the buffer to write into (mutex held by caller in LOCKED mode)
+ * The resize gate stays entered when the claimed range is not empty (caller leaves it once done with the range)
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param length   Length in bytes wanted
+ * @param partial  Flag to accept a range smaller than `length` (never waits)
+ * @param blocking Flag to wait for enough free space
+ * @param deadline Absolute CLOCK_MONOTONIC deadline for the wait (NULL for none)
+ * @param cursor   Pointer to cursor variable to set to the start of the range
+ * @return Length of the claimed range in bytes
+ */
+static size_t CircularBuffer_claimWrite( CircularBuffer_t * cbuff, size_t length, bool partial, bool blocking, const struct timespec * deadline, u_int64_t * cursor ) {
+    const bool          locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    const bool          shared = ( cbuff->options.mode == CIRCULARBUFFER_MODE_MPSC || cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC );
+    _Atomic u_int64_t * head   = ( shared ? &cbuff->position.write_claim : &cbuff->position.write );
+    u_int64_t           write  = 0;
+    size_t              n      = 0;
+    bool                retry  = false;
+
+    const CircularBuffer_Uring_t * engine = atomic_load_explicit( &cbuff->engine.producer, memory_order_relaxed );
+
+    if( engine != NULL && engine != CircularBuffer_engine ) {
+        fprintf( stderr,
+                 "[CircularBuffer_claimWrite( %p, %lu, %d, %d, %p, %p )] Producer side owned by io_uring engine %p.\n",
+                 cbuff, length, partial, blocking, deadline, cursor, engine
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    CircularBuffer_enterGate( cbuff, &cbuff->gate.producers );
+    write = atomic_load_explicit( head, memory_order_relaxed );
+
+    if( cbuff->options.mode == CIRCULARBUFFER_MODE_BROADCAST && !CircularBuffer_isWritable( cbuff, write, length ) ) {
+        CircularBuffer_updateTail( cbuff );
+    }
+
+    do {
+        bool waiting = true;
+
+        const bool busy = ( locked && CircularBuffer_busy( &cbuff->position.write_claim, &cbuff->position.write ) );
+
+        if( blocking && !partial && ( busy || !CircularBuffer_isWritable( cbuff, write, length ) ) ) {
+            if( locked ) {
+                atomic_fetch_add_explicit( &cbuff->parking.producers.waiters, 1, memory_order_relaxed );
+
+                while( waiting && ( CircularBuffer_busy( &cbuff->position.write_claim, &cbuff->position.write )
+                                 || !CircularBuffer_isWritable( cbuff, write, length ) ) )
+                {
+                    waiting = CircularBuffer_condWait( &cbuff->space, &cbuff->mutex, deadline );
+                    write   = atomic_load_explicit( head, memory_order_relaxed );
+                }
+
+                atomic_fetch_sub_explicit( &cbuff->parking.producers.waiters, 1, memory_order_relaxed );
+
+            } else { //a swap can happen while waiting (cursors are rebased)
+                CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+                waiting = CircularBuffer_wait( cbuff, &cbuff->parking.producers, &cbuff->space, CircularBuffer_isWritable, write, length, deadline );
+                CircularBuffer_enterGate( cbuff, &cbuff->gate.producers );
+                write   = atomic_load_explicit( head, memory_order_relaxed );
+            }
+        }
+
+        const u_int64_t read       = atomic_load_explicit( &cbuff->position.read, memory_order_acquire );
+        const size_t    free_bytes = ( read > write ? 0 : cbuff->size - (size_t) ( write - read ) ); //`write` can be stale when shared
+
+        n = ( length <= free_bytes ? length : ( partial ? free_bytes : 0 ) );
+
+        if( locked && CircularBuffer_busy( &cbuff->position.write_claim, &cbuff->position.write ) ) //range being filled by `writeFromFd(..)`/`spliceFromPipe(..)`
+            n = 0;
+
+        if( n > 0 ) {
+            retry = ( shared && !atomic_compare_exchange_weak_explicit( head, &write, ( write + n ), memory_order_relaxed, memory_order_relaxed ) );
+        } else { //space taken by another producer (or the wait woken up by a resize) since the wait
+            retry = ( blocking && !partial && waiting );
+            write = atomic_load_explicit( head, memory_order_relaxed );
+        }
+
+    } while( retry );
+
+    if( n == 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+
+    *cursor = write;
+    return n;
+}
+
+/**
+ * [PRIVATE] Publishes a written range to the consumer(s) (mutex held by caller in LOCKED mode)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param cursor Start of the range (as claimed)
+ * @param n      Length of the range in bytes
+ */
+static void CircularBuffer_publishWrite( CircularBuffer_t * cbuff, u_int64_t cursor, size_t n ) {
+    if( n == 0 )
+        return; //EARLY RETURN
+
+    switch( cbuff->options.mode ) {
+        case CIRCULARBUFFER_MODE_LOCKED:
+            CircularBuffer_advanceWritePos( cbuff, n );
+            CircularBuffer_wakeConsumers( cbuff, ( cursor + n ) );
+            break;
+
+        case CIRCULARBUFFER_MODE_MPSC: //claims are published in order
+        case CIRCULARBUFFER_MODE_MPMC:
+            CircularBuffer_awaitTurn( cbuff, &cbuff->position.write, cursor );
+            atomic_store_explicit( &cbuff->position.write, ( cursor + n ), memory_order_release );
+            CircularBuffer_wakeConsumers( cbuff, ( cursor + n ) );
+            break;
+
+        default:
+            atomic_store_explicit( &cbuff->position.write, ( cursor + n ), memory_order_release );
+            CircularBuffer_wakeConsumers( cbuff, ( cursor + n ) );
+            break;
+    }
+}
+
+/**
+ * [PRIVATE] Claims the readable range of the buffer (mutex held by caller in LOCKED mode)
+ * The resize gate stays entered when the claimed range is not empty (caller leaves it once done with the range)
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param length   Max length in bytes wanted
+ * @param blocking Flag to wait for data when the buffer is empty
+ * @param deadline Absolute CLOCK_MONOTONIC deadline for the wait (NULL for none)
+ * @param cursor   Pointer to cursor variable to set to the start of the range
+ * @return Length of the claimed range in bytes
+ */
+static size_t CircularBuffer_claimRead( CircularBuffer_t * cbuff, size_t length, bool blocking, const struct timespec * deadline, u_int64_t * cursor ) {
+    const bool          locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    const bool          shared = ( cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC );
+    _Atomic u_int64_t * head   = ( shared ? &cbuff->position.read_claim : &cbuff->position.read );
+    u_int64_t           read   = 0;
+    u_int64_t           write  = 0;
+    size_t              n      = 0;
+    bool                retry  = false;
+
+    const CircularBuffer_Uring_t * engine = atomic_load_explicit( &cbuff->engine.consumer, memory_order_relaxed );
+
+    if( length == 0 ) { //nothing to wait for
+        *cursor = atomic_load_explicit( head, memory_order_relaxed );
+        return 0; //EARLY RETURN
+    }
+
+    if( engine != NULL && engine != CircularBuffer_engine ) {
+        fprintf( stderr,
+                 "[CircularBuffer_claimRead( %p, %lu, %d, %p, %p )] Consumer side owned by io_uring engine %p.\n",
+                 cbuff, length, blocking, deadline, cursor, engine
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    CircularBuffer_enterGate( cbuff, &cbuff->gate.consumers );
+    read = atomic_load_explicit( head, memory_order_relaxed );
+
+    do {
+        bool waiting = true;
+
+        write = atomic_load_explicit( &cbuff->position.write, memory_order_acquire );
+
+        const bool busy = ( locked && CircularBuffer_busy( &cbuff->position.read_claim, &cbuff->position.read ) );
+
+        if( blocking && locked && ( busy || write == read ) ) {
+            atomic_fetch_add_explicit( &cbuff->parking.consumers.waiters, 1, memory_order_relaxed );
+
+            while( waiting && ( write == read || CircularBuffer_busy( &cbuff->position.read_claim, &cbuff->position.read ) ) ) {
+                waiting = CircularBuffer_condWait( &cbuff->ready, &cbuff->mutex, deadline );
+                read    = atomic_load_explicit( head, memory_order_relaxed );
+                write   = atomic_load_explicit( &cbuff->position.write, memory_order_relaxed );
+            }
+
+            atomic_fetch_sub_explicit( &cbuff->parking.consumers.waiters, 1, memory_order_relaxed );
+
+        } else if( blocking && write == read ) { //a swap can happen while waiting (cursors are rebased)
+            CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+            waiting = CircularBuffer_wait( cbuff, &cbuff->parking.consumers, &cbuff->ready, CircularBuffer_isReadable, read, 1, deadline );
+            CircularBuffer_enterGate( cbuff, &cbuff->gate.consumers );
+            read    = atomic_load_explicit( head, memory_order_relaxed );
+            write   = atomic_load_explicit( &cbuff->position.write, memory_order_acquire );
+        }
+
+        const size_t bytes_available = ( read > write ? 0 : (size_t) ( write - read ) ); //`read` can be stale when shared
+
+        n = ( bytes_available < length ? bytes_available : length );
+
+        if( locked && CircularBuffer_busy( &cbuff->position.read_claim, &cbuff->position.read ) ) //range being drained by `readToFd(..)`
+            n = 0;
+
+        if( n > 0 ) {
+            retry = ( shared && !atomic_compare_exchange_weak_explicit( head, &read, ( read + n ), memory_order_relaxed, memory_order_relaxed ) );
+        } else { //data taken by another consumer (or the wait woken up by a resize) since the wait
+            retry = ( blocking && waiting && length > 0 );
+            read  = atomic_load_explicit( head, memory_order_relaxed );
+        }
+
+    } while( retry );
+
+    if( n == 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+    *cursor = read;
+    return n;
+}
+
+/**
+ * [PRIVATE] Releases a read range back to the producer(s) (mutex held by caller in LOCKED mode)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param cursor Start of the range (as claimed)
+ * @param n      Length of the range in bytes
+ */
+static void CircularBuffer_publishRead( CircularBuffer_t * cbuff, u_int64_t cursor, size_t n ) {
+    if( n == 0 )
+        return; //EARLY RETURN
+
+    switch( cbuff->options.mode ) {
+        case CIRCULARBUFFER_MODE_LOCKED:
+            CircularBuffer_advanceReadPos( cbuff, n );
+
+            if( atomic_load_explicit( &cbuff->parking.producers.waiters, memory_order_relaxed ) > 0 ) {
+                pthread_cond_broadcast( &cbuff->space );
+            }
+
+            break;
+
+        case CIRCULARBUFFER_MODE_MPMC: //claims are released in order
+            CircularBuffer_awaitTurn( cbuff, &cbuff->position.read, cursor );
+            atomic_store_explicit( &cbuff->position.read, ( cursor + n ), memory_order_release );
+            CircularBuffer_wake( cbuff, &cbuff->parking.producers, &cbuff->space );
+            break;
+
+        default:
+            atomic_store_explicit( &cbuff->position.read, ( cursor + n ), memory_order_release );
+            CircularBuffer_wake( cbuff, &cbuff->parking.producers, &cbuff->space );
+            break;
+    }
+}
+
+/**
+ * [PRIVATE] Writes a chunk to the buffer (no arg checks)
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param src      Source byte buffer
+ * @param length   Source length in bytes to copy
+ * @param partial  Flag to write as much of the chunk as fits instead of all or nothing (never blocks)
+ * @param blocking Flag to wait for enough free space
+ * @param deadline Absolute CLOCK_MONOTONIC deadline for the wait (NULL for none)
+ * @param crc      Pointer to running CRC32C to update with the bytes written (NULL for none)
+ * @return Number or bytes written
+ */
+static size_t CircularBuffer_write( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length, bool partial, bool blocking, const struct timespec * deadline, u_int32_t * crc ) {
+    if( blocking && length > cbuff->size ) {
+        fprintf( stderr,
+                 "[CircularBuffer_write( %p, %p, %lu, %d, %d, %p )] Chunk larger than the buffer (%lu).\n",
+                 cbuff, src, length, partial, blocking, deadline, cbuff->size
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  write  = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    const size_t bytes_writen = CircularBuffer_claimWrite( cbuff, length, partial, blocking, deadline, &write );
+
+    if( bytes_writen > 0 ) {
+        const size_t offset = CircularBuffer_offset( cbuff, write );
+
+        if( crc != NULL ) {
+            *crc = CircularBuffer_crcKernel.copyCrc( &cbuff->buffer[offset], src, bytes_writen, *crc );
+        } else {
+            CircularBuffer_copyIn( cbuff, &cbuff->buffer[offset], src, bytes_writen );
+        }
+
+#ifndef NDEBUG
+        printf( "[CircularBuffer_write( %p, %p, %lu, %d, %d, %p )] [%ld:'%d'->'%d'] to [%ld/%lu:'%d'->'%d']\n",
+                cbuff, src, length, partial, blocking, deadline,
+                offset, src[0], cbuff->buffer[offset],
+                ( offset + bytes_writen ), ( write + bytes_writen ), src[bytes_writen - 1], cbuff->buffer[offset + bytes_writen - 1] );
+#endif
+    }
+
+    CircularBuffer_publishWrite( cbuff, write, bytes_writen );
+
+    if( bytes_writen > 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+
+    if( locked )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    if( !partial && !blocking && bytes_writen < length ) { //reported outside of the lock
+        fprintf( stderr,
+                 "[CircularBuffer_write( %p, %p, %lu, %d, %d, %p )] "
+                 "Free space too small (%lu). Consider making the buffer larger (%lu).\n",
+                 cbuff, src, length, partial, blocking, deadline,
+                 ( cbuff->size - (size_t) ( write - atomic_load( &cbuff->position.read ) ) ), cbuff->size
+        );
+    }
+
+    return bytes_writen;
+}
+
+/**
+ * [PRIVATE] Reads a chunk and copies to a buffer (no arg checks)
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param target   Target buffer
+ * @param length   Length to read and transfer to buffer
+ * @param blocking Flag to wait for data when the buffer is empty
+ * @param deadline Absolute CLOCK_MONOTONIC deadline for the wait (NULL for none)
+ * @param crc      Pointer to running CRC32C to update with the bytes read (NULL for none)
+ * @return Actual length read
+ */
+static size_t CircularBuffer_read( CircularBuffer_t * cbuff, u_int8_t * target, size_t length, bool blocking, const struct timespec * deadline, u_int32_t * crc ) {
+    if( cbuff->options.mode == CIRCULARBUFFER_MODE_BROADCAST ) {
+        fprintf( stderr,
+                 "[CircularBuffer_read( %p, %p, %lu, %d, %p )] BROADCAST mode buffers are read with `readChunkAs(..)`.\n",
+                 cbuff, target, length, blocking, deadline
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    int        ret    = 0;
+    u_int64_t  read   = 0;
+
+    if( locked && ( ret = pthread_mutex_lock( &cbuff->mutex ) ) != 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_read( %p, %p, %lu, %d, %p )] Failed to lock mutex: %s (%d).\n",
+                 cbuff, target, length, blocking, deadline, CircularBuffer_getPThreadErrStr( ret ), ret
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    const size_t bytes_read = CircularBuffer_claimRead( cbuff, length, blocking, deadline, &read );
+
+    if( bytes_read > 0 ) {
+        const size_t offset = CircularBuffer_offset( cbuff, read );
+
+        if( crc != NULL ) {
+            *crc = CircularBuffer_crcKernel.copyCrc( target, &cbuff->buffer[offset], bytes_read, *crc );
+        } else {
+            CircularBuffer_copyOut( cbuff, target, &cbuff->buffer[offset], bytes_read );
+        }
+
+#ifndef NDEBUG
+        printf( "[CircularBuffer_read( %p, %p, %lu, %d, %p )] [%ld:'%d'] to [%ld/%lu:'%d']\n",
+                cbuff, target, length, blocking, deadline,
+                offset, cbuff->buffer[offset],
+                ( offset + bytes_read ), ( read + bytes_read ), cbuff->buffer[( offset + bytes_read ) - 1] );
+#endif
+    }
+
+    CircularBuffer_publishRead( cbuff, read, bytes_read );
+
+    if( bytes_read > 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+    if( locked && ( ret = pthread_mutex_unlock( &cbuff->mutex ) ) != 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_read( %p, %p, %lu, %d, %p )] Failed to unlock mutex: %s (%d).\n",
+                 cbuff, target, length, blocking, deadline, CircularBuffer_getPThreadErrStr( ret ), ret
+        );
+    }
+
+    CircularBuffer_idleTrim( cbuff );
+
+    return bytes_read;
+}
+
+/**
+ * [THREAD-SAFE] Writes a chunk to the buffer (no arg checks)
+ * @param buffer Pointer to CircularBuffer_t object
+ * @param src    Source byte buffer
+ * @param length Source length in bytes to copy
+ * @return Number or bytes written
+ */
+static size_t CircularBuffer_writeChunk( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length ) {
+    return CircularBuffer_write( cbuff, src, length, false, cbuff->options.blocking_write, NULL, NULL );
+}
+
+/**
+ * [THREAD-SAFE] Writes a chunk to the buffer, waiting for enough free space up to a deadline
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param src      Source byte buffer
+ * @param length   Source length in bytes to copy
+ * @param deadline Absolute CLOCK_MONOTONIC deadline
+ * @return Number or bytes written (0 if the deadline was reached)
+ */
+static size_t CircularBuffer_writeChunkUntil( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length, const struct timespec * deadline ) {
+    if( cbuff == NULL || src == NULL || deadline == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_writeChunkUntil( %p, %p, %lu, %p )] Pointer arg is NULL.\n",
+                 cbuff, src, length, deadline
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    return CircularBuffer_write( cbuff, src, length, false, true, deadline, NULL );
+}
+
+/**
+ * [THREAD-SAFE] Writes as much of a chunk as currently fits in the buffer without waiting (no arg checks)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param src    Source byte buffer
+ * @param length Source length in bytes to copy
+ * @return Number or bytes written (min(length, free space))
+ */
+static size_t CircularBuffer_writeSome( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length ) {
+    return CircularBuffer_write( cbuff, src, length, true, false, NULL, NULL );
+}
+
+/**
+ * [THREAD-SAFE] Writes a chunk to the buffer, updating a running CRC32C with it while copying
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param src    Source byte buffer
+ * @param length Source length in bytes to copy
+ * @param crc    Pointer to running CRC32C (0 to start)
+ * @return Number or bytes written
+ */
+static size_t CircularBuffer_writeChunkCrc( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length, u_int32_t * crc ) {
+    if( cbuff == NULL || src == NULL || crc == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_writeChunkCrc( %p, %p, %lu, %p )] Pointer arg is NULL.\n",
+                 cbuff, src, length, crc
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    return CircularBuffer_write( cbuff, src, length, false, cbuff->options.blocking_write, NULL, crc );
+}
+
+/**
+ * [THREAD-SAFE] Writes a set of segments to the buffer as one chunk (all or nothing)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param iov    Source segments
+ * @param iovcnt Number of segments
+ * @return Number or bytes written (0 or the sum of the segment lengths)
+ */
+static size_t CircularBuffer_writeChunkV( CircularBuffer_t * cbuff, const struct iovec * iov, int iovcnt ) {
+    if( cbuff == NULL || iov == NULL || iovcnt < 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_writeChunkV( %p, %p, %d )] Pointer arg is NULL or negative segment count.\n",
+                 cbuff, iov, iovcnt
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    size_t length = 0;
+
+    for( int i = 0; i < iovcnt; ++i ) {
+        length += iov[i].iov_len;
+    }
+
+    if( length == 0 || length > cbuff->size ) {
+        if( length > 0 ) {
+            fprintf( stderr,
+                     "[CircularBuffer_writeChunkV( %p, %p, %d )] Chunk larger than the buffer (%lu/%lu).\n",
+                     cbuff, iov, iovcnt, length, cbuff->size
+            );
+        }
+
+        return 0; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  write  = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    const size_t bytes_writen = CircularBuffer_claimWrite( cbuff, length, false, cbuff->options.blocking_write, NULL, &write );
+
+    if( bytes_writen > 0 ) {
+        u_int8_t * dst = &cbuff->buffer[CircularBuffer_offset( cbuff, write )];
+
+        for( int i = 0; i < iovcnt; ++i ) {
+            CircularBuffer_copyIn( cbuff, dst, iov[i].iov_base, iov[i].iov_len );
+            dst += iov[i].iov_len;
+        }
+    }
+
+    CircularBuffer_publishWrite( cbuff, write, bytes_writen );
+
+    if( bytes_writen > 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+
+    if( locked )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    if( bytes_writen == 0 && !cbuff->options.blocking_write ) { //reported outside of the lock
+        fprintf( stderr,
+                 "[CircularBuffer_writeChunkV( %p, %p, %d )] "
+                 "Free space too small for %lu bytes. Consider making the buffer larger (%lu).\n",
+                 cbuff, iov, iovcnt, length, cbuff->size
+        );
+    }
+
+    return bytes_writen;
+}
+
+/**
+ * [THREAD-SAFE] Reserves a contiguous range at the write position to encode into in place
+ * (LOCKED mode: the mutex is held until `commitWrite(..)`)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param length Length in bytes to reserve
+ * @return Pointer to the reserved range in the buffer (NULL on failure or not enough free space)
+ */
+static u_int8_t * CircularBuffer_reserveWrite( CircularBuffer_t * cbuff, size_t length ) {
+    if( cbuff == NULL || length == 0 || length > cbuff->size || CircularBuffer_writeReservation.cbuff != NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_reserveWrite( %p, %lu )] "
+                 "CircularBuffer_t is NULL, bad length or a reservation is already pending on this thread.\n",
+                 cbuff, length
+        );
+
+        return NULL; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  write  = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    if( CircularBuffer_claimWrite( cbuff, length, false, cbuff->options.blocking_write, NULL, &write ) == 0 ) {
+        if( locked )
+            pthread_mutex_unlock( &cbuff->mutex );
+
+        return NULL; //EARLY RETURN
+    }
+
+    CircularBuffer_writeReservation = (CircularBuffer_Reservation_t) { cbuff, write, length };
+
+    return &cbuff->buffer[CircularBuffer_offset( cbuff, write )];
+}
+
+/**
+ * [THREAD-SAFE] Publishes the calling thread's `reserveWrite(..)` range
+ * (LOCKED/SPSC/BROADCAST modes: any start of the range, 0 cancelling the reservation;
+ * MPSC/MPMC modes: other producers may have claimed after the reservation so only the whole range is published,
+ * a shorter length (0 included) is refused and leaves the reservation pending: it cannot be cancelled)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param length Length in bytes to publish (=< reserved length)
+ * @return Number of bytes published (0 when refused)
+ */
+static size_t CircularBuffer_commitWrite( CircularBuffer_t * cbuff, size_t length ) {
+    CircularBuffer_Reservation_t * reservation = &CircularBuffer_writeReservation;
+
+    if( cbuff == NULL || reservation->cbuff != cbuff || length > reservation->length ) {
+        fprintf( stderr,
+                 "[CircularBuffer_commitWrite( %p, %lu )] No matching reservation on this thread or length too large.\n",
+                 cbuff, length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    const bool shared = ( cbuff->options.mode == CIRCULARBUFFER_MODE_MPSC || cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC );
+
+    if( shared && length < reservation->length ) { //the end of the range would be published unwritten once claimed past
+        fprintf( stderr,
+                 "[CircularBuffer_commitWrite( %p, %lu )] MPSC/MPMC mode reservations are committed whole (%lu).\n",
+                 cbuff, length, reservation->length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    CircularBuffer_publishWrite( cbuff, reservation->cursor, length );
+    CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+
+    if( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    *reservation = (CircularBuffer_Reservation_t) { NULL, 0, 0 };
+
+    return length;
+}
+
+/**
+ * [THREAD-SAFE] Reads from a file descriptor straight into the free range at the write position
+ * (LOCKED mode: the range is claimed under the mutex and read(2) into without it, other producers wait for it,
+ * resizable lock-free modes: the mapping is pinned for the syscall instead of resize/trim held off)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param fd    File descriptor to read from (file, pipe, socket, ...)
+ * @param max   Max length in bytes to read
+ * @return Number of bytes written to the buffer, 0 on end-of-file or -1 on error (errno set, ENOBUFS when full or,
+ *         without `options.blocking_write`, when another producer's range is being read into)
+ */
+static ssize_t CircularBuffer_writeFromFd( CircularBuffer_t * cbuff, int fd, size_t max ) {
+    if( cbuff == NULL || cbuff->options.mode == CIRCULARBUFFER_MODE_MPSC || cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC ) {
+        fprintf( stderr,
+                 "[CircularBuffer_writeFromFd( %p, %i, %lu )] "
+                 "CircularBuffer_t is NULL or MPSC/MPMC mode (a short read cannot give back the end of a claim).\n",
+                 cbuff, fd, max
+        );
+
+        errno = EINVAL;
+        return -1; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  write  = 0;
+    ssize_t    ret    = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    if( cbuff->options.blocking_write ) { //waits for at least a byte of free space (nothing to claim in single producer modes)
+        if( CircularBuffer_claimWrite( cbuff, 1, false, true, NULL, &write ) > 0 )
+            CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+    }
+
+    const size_t n = CircularBuffer_claimWrite( cbuff, max, true, false, NULL, &write );
+
+    if( n > 0 ) {
+        if( locked ) { //the syscall can block: the range is kept from other producers instead
+            atomic_store_explicit( &cbuff->position.write_claim, ( write + n ), memory_order_relaxed );
+            pthread_mutex_unlock( &cbuff->mutex );
+        }
+
+        CircularBuffer_pin( cbuff, &cbuff->gate.producers ); //gated modes: the mapping is pinned for the syscall, not the gate held
+
+        ret = read( fd, &cbuff->buffer[CircularBuffer_offset( cbuff, write )], n );
+
+        if( locked )
+            pthread_mutex_lock( &cbuff->mutex );
+
+        if( ret > 0 )
+            CircularBuffer_publishWrite( cbuff, write, (size_t) ret );
+
+        if( locked )
+            CircularBuffer_release( cbuff, &cbuff->position.write_claim, &cbuff->position.write );
+
+        CircularBuffer_unpin( cbuff );
+
+    } else if( max > 0 ) {
+        errno = ENOBUFS;
+        ret   = -1;
+    }
+
+    if( locked )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    return ret;
+}
+
+/**
+ * [THREAD-SAFE] Splices from a pipe straight into the buffer's memfd at the write position, read(2) into the mapping
+ * for huge page buffers (hugetlbfs does not support splice(2) writes)
+ * (LOCKED mode: the range is claimed under the mutex and spliced into without it, other producers wait for it,
+ * resizable lock-free modes: the mapping is pinned for the syscall instead of resize/trim held off)
+ * @param cbuff   Pointer to CircularBuffer_t object
+ * @param pipe_fd Read end of a pipe
+ * @param max     Max length in bytes to splice (capped to the end of the memfd)
+ * @return Number of bytes written to the buffer, 0 when the pipe's write end is closed or -1 on error (errno set, ENOBUFS when full
+ *         or, without `options.blocking_write`, when another producer's range is being spliced into)
+ */
+static ssize_t CircularBuffer_spliceFromPipe( CircularBuffer_t * cbuff, int pipe_fd, size_t max ) {
+    if( cbuff == NULL || cbuff->options.mode == CIRCULARBUFFER_MODE_MPSC || cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC ) {
+        fprintf( stderr,
+                 "[CircularBuffer_spliceFromPipe( %p, %i, %lu )] "
+                 "CircularBuffer_t is NULL or MPSC/MPMC mode (a short splice cannot give back the end of a claim).\n",
+                 cbuff, pipe_fd, max
+        );
+
+        errno = EINVAL;
+        return -1; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  write  = 0;
+    ssize_t    ret    = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    if( cbuff->options.blocking_write ) { //waits for at least a byte of free space (nothing to claim in single producer modes)
+        if( CircularBuffer_claimWrite( cbuff, 1, false, true, NULL, &write ) > 0 )
+            CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers );
+    }
+
+    size_t n      = CircularBuffer_claimWrite( cbuff, max, true, false, NULL, &write );
+    loff_t offset = (loff_t) CircularBuffer_offset( cbuff, write );
+
+    if( n > ( cbuff->size - (size_t) offset ) ) //the memfd is not mirrored, only its mapping is
+        n = ( cbuff->size - (size_t) offset );
+
+    if( n > 0 ) {
+        if( locked ) { //the syscall can block: the range is kept from other producers instead
+            atomic_store_explicit( &cbuff->position.write_claim, ( write + n ), memory_order_relaxed );
+            pthread_mutex_unlock( &cbuff->mutex );
+        }
+
+        CircularBuffer_pin( cbuff, &cbuff->gate.producers ); //gated modes: the mapping is pinned for the syscall, not the gate held
+
+        if( cbuff->page_size > (size_t) getpagesize() ) { //hugetlbfs has no splice_write: plain read(2) into the mapping
+            ret = read( pipe_fd, &cbuff->buffer[offset], n );
+        } else {
+            ret = CircularBuffer_splice( pipe_fd, NULL, cbuff->fd, &offset, n, 0 );
+        }
+
+        if( locked )
+            pthread_mutex_lock( &cbuff->mutex );
+
+        if( ret > 0 )
+            CircularBuffer_publishWrite( cbuff, write, (size_t) ret );
+
+        if( locked )
+            CircularBuffer_release( cbuff, &cbuff->position.write_claim, &cbuff->position.write );
+
+        CircularBuffer_unpin( cbuff );
+
+    } else if( max > 0 ) {
+        errno = ENOBUFS;
+        ret   = -1;
+    }
+
+    if( locked )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    return ret;
+}
+
+/**
+ * [THREAD-SAFE] Reads a chunk and copies to a buffer
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param target Target buffer
+ * @param length Length to read and transfer to buffer
+ * @return Actual length read
+ */
+static size_t CircularBuffer_readChunk( CircularBuffer_t * cbuff, u_int8_t * target, size_t length ) {
+    if( cbuff == NULL || target == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_readChunk( %p, %p, %lu )] Pointer arg is NULL.\n",
+                 cbuff, target, length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    return CircularBuffer_read( cbuff, target, length, true, NULL, NULL );
+}
+
+/**
+ * [THREAD-SAFE] Reads a chunk and copies to a buffer, waiting for data up to a deadline
+ * @param cbuff    Pointer to CircularBuffer_t object
+ * @param target   Target buffer
+ * @param length   Length to read and transfer to buffer
+ * @param deadline Absolute CLOCK_MONOTONIC deadline
+ * @return Actual length read (0 if the deadline was reached)
+ */
+static size_t CircularBuffer_readChunkUntil( CircularBuffer_t * cbuff, u_int8_t * target, size_t length, const struct timespec * deadline ) {
+    if( cbuff == NULL || target == NULL || deadline == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_readChunkUntil( %p, %p, %lu, %p )] Pointer arg is NULL.\n",
+                 cbuff, target, length, deadline
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    return CircularBuffer_read( cbuff, target, length, true, deadline, NULL );
+}
+
+/**
+ * [THREAD-SAFE] Reads a chunk and copies to a buffer without waiting when the buffer is empty
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param target Target buffer
+ * @param length Length to read and transfer to buffer
+ * @return Actual length read (0 when empty)
+ */
+static size_t CircularBuffer_tryReadChunk( CircularBuffer_t * cbuff, u_int8_t * target, size_t length ) {
+    if( cbuff == NULL || target == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_tryReadChunk( %p, %p, %lu )] Pointer arg is NULL.\n",
+                 cbuff, target, length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    return CircularBuffer_read( cbuff, target, length, false, NULL, NULL );
+}
+
+/**
+ * [THREAD-SAFE] Reads a chunk and copies to a buffer, updating a running CRC32C with it while copying
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param target Target buffer
+ * @param length Length to read and transfer to buffer
+ * @param crc    Pointer to running CRC32C (0 to start)
+ * @return Actual length read
+ */
+static size_t CircularBuffer_readChunkCrc( CircularBuffer_t * cbuff, u_int8_t * target, size_t length, u_int32_t * crc ) {
+    if( cbuff == NULL || target == NULL || crc == NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_readChunkCrc( %p, %p, %lu, %p )] Pointer arg is NULL.\n",
+                 cbuff, target, length, crc
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    return CircularBuffer_read( cbuff, target, length, true, NULL, crc );
+}
+
+/**
+ * [THREAD-SAFE] Reads a chunk and scatters it over a set of segments, waiting for data when empty
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param iov    Target segments (filled in order)
+ * @param iovcnt Number of segments
+ * @return Actual length read (=< sum of the segment lengths)
+ */
+static size_t CircularBuffer_readChunkV( CircularBuffer_t * cbuff, const struct iovec * iov, int iovcnt ) {
+    if( cbuff == NULL || iov == NULL || iovcnt < 0 || cbuff->options.mode == CIRCULARBUFFER_MODE_BROADCAST ) {
+        fprintf( stderr,
+                 "[CircularBuffer_readChunkV( %p, %p, %d )] Pointer arg is NULL, negative segment count or BROADCAST mode.\n",
+                 cbuff, iov, iovcnt
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    size_t length = 0;
+
+    for( int i = 0; i < iovcnt; ++i ) {
+        length += iov[i].iov_len;
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  read   = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    const size_t     bytes_read = CircularBuffer_claimRead( cbuff, length, true, NULL, &read );
+    const u_int8_t * src        = &cbuff->buffer[CircularBuffer_offset( cbuff, read )];
+    size_t           remaining  = bytes_read;
+
+    for( int i = 0; i < iovcnt && remaining > 0; ++i ) {
+        const size_t n = ( iov[i].iov_len < remaining ? iov[i].iov_len : remaining );
+
+        CircularBuffer_copyOut( cbuff, iov[i].iov_base, src, n );
+        src       += n;
+        remaining -= n;
+    }
+
+    CircularBuffer_publishRead( cbuff, read, bytes_read );
+
+    if( bytes_read > 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+    if( locked )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    CircularBuffer_idleTrim( cbuff );
+
+    return bytes_read;
+}
+
+/**
+ * [THREAD-SAFE] Gets the readable range at the read position to work on in place, waiting for data when empty
+ * (LOCKED mode: the mutex is held until `consume(..)`)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param length Pointer to variable to set to the length of the readable range
+ * @return Pointer to the readable range in the buffer (NULL on failure)
+ */
+static const u_int8_t * CircularBuffer_peekRead( CircularBuffer_t * cbuff, size_t * length ) {
+    if( cbuff == NULL || length == NULL || cbuff->options.mode == CIRCULARBUFFER_MODE_BROADCAST || CircularBuffer_readReservation.cbuff != NULL ) {
+        fprintf( stderr,
+                 "[CircularBuffer_peekRead( %p, %p )] "
+                 "Pointer arg is NULL, BROADCAST mode or a peek is already pending on this thread.\n",
+                 cbuff, length
+        );
+
+        return NULL; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  read   = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    *length = CircularBuffer_claimRead( cbuff, cbuff->size, true, NULL, &read );
+
+    CircularBuffer_readReservation = (CircularBuffer_Reservation_t) { cbuff, read, *length };
+
+    return &cbuff->buffer[CircularBuffer_offset( cbuff, read )];
+}
+
+/**
+ * [THREAD-SAFE] Releases the start of the calling thread's `peekRead(..)` range back to the producer(s)
+ * (MPMC mode: other consumers may have claimed after the peeked range so it is only consumed whole,
+ * a shorter length is refused and leaves the peek pending)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param length Length in bytes to consume (=< peeked length)
+ * @return Number of bytes consumed (0 when refused)
+ */
+static size_t CircularBuffer_consume( CircularBuffer_t * cbuff, size_t length ) {
+    CircularBuffer_Reservation_t * reservation = &CircularBuffer_readReservation;
+
+    if( cbuff == NULL || reservation->cbuff != cbuff || length > reservation->length ) {
+        fprintf( stderr,
+                 "[CircularBuffer_consume( %p, %lu )] No matching peek on this thread or length too large.\n",
+                 cbuff, length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    if( cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC && length < reservation->length ) { //the end of the range would be released unread once claimed past
+        fprintf( stderr,
+                 "[CircularBuffer_consume( %p, %lu )] MPMC mode peeks are consumed whole (%lu).\n",
+                 cbuff, length, reservation->length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    CircularBuffer_publishRead( cbuff, reservation->cursor, length );
+
+    if( reservation->length > 0 )
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+    if( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    *reservation = (CircularBuffer_Reservation_t) { NULL, 0, 0 };
+
+    CircularBuffer_idleTrim( cbuff );
+
+    return length;
+}
+
+/**
+ * [THREAD-SAFE] Writes the readable range at the read position straight to a file descriptor, waiting for data when empty
+ * (LOCKED mode: the range is claimed under the mutex and written out without it, other consumers wait for it,
+ * resizable lock-free modes: the mapping is pinned for the syscall instead of resize/trim held off)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @param fd    File descriptor to write to (file, pipe, socket, ...)
+ * @param max   Max length in bytes to write
+ * @return Number of bytes accepted by the kernel (and consumed from the buffer) or -1 on error (errno set)
+ */
+static ssize_t CircularBuffer_readToFd( CircularBuffer_t * cbuff, int fd, size_t max ) {
+    if( cbuff == NULL || cbuff->options.mode == CIRCULARBUFFER_MODE_MPMC || cbuff->options.mode == CIRCULARBUFFER_MODE_BROADCAST ) {
+        fprintf( stderr,
+                 "[CircularBuffer_readToFd( %p, %i, %lu )] "
+                 "CircularBuffer_t is NULL or MPMC/BROADCAST mode (a short write cannot give back the end of a claim).\n",
+                 cbuff, fd, max
+        );
+
+        errno = EINVAL;
+        return -1; //EARLY RETURN
+    }
+
+    const bool locked = ( cbuff->options.mode == CIRCULARBUFFER_MODE_LOCKED );
+    u_int64_t  read   = 0;
+    ssize_t    ret    = 0;
+
+    if( locked )
+        pthread_mutex_lock( &cbuff->mutex );
+
+    const size_t n = CircularBuffer_claimRead( cbuff, max, true, NULL, &read );
+
+    if( n > 0 ) {
+        if( locked ) { //the syscall can block: the range is kept from other consumers instead
+            atomic_store_explicit( &cbuff->position.read_claim, ( read + n ), memory_order_relaxed );
+            pthread_mutex_unlock( &cbuff->mutex );
+        }
+
+        CircularBuffer_pin( cbuff, &cbuff->gate.consumers ); //gated modes: the mapping is pinned for the syscall, not the gate held
+
+        ret = write( fd, &cbuff->buffer[CircularBuffer_offset( cbuff, read )], n );
+
+        if( locked )
+            pthread_mutex_lock( &cbuff->mutex );
+
+        if( ret > 0 )
+            CircularBuffer_publishRead( cbuff, read, (size_t) ret );
+
+        if( locked )
+            CircularBuffer_release( cbuff, &cbuff->position.read_claim, &cbuff->position.read );
+
+        CircularBuffer_unpin( cbuff );
+    }
+
+    if( locked )
+        pthread_mutex_unlock( &cbuff->mutex );
+
+    CircularBuffer_idleTrim( cbuff );
+
+    return ret;
+}
+
+/**
+ * [THREAD-SAFE] Registers a broadcast reader (BROADCAST mode)
+ * @param cbuff Pointer to CircularBuffer_t object
+ * @return Reader ID (-1 on failure)
  */
-static int CircularBuffer_memfd_create( const char * name, unsigned int flags ) {
-    long fd   = syscall( __NR_memfd_create, name, flags );
-    int  cast = 0;
+static int CircularBuffer_addReader( CircularBuffer_t * cbuff ) {
+    if( cbuff == NULL || cbuff->options.mode != CIRCULARBUFFER_MODE_BROADCAST ) {
+        fprintf( stderr,
+                 "[CircularBuffer_addReader( %p )] CircularBuffer_t is NULL or not in BROADCAST mode.\n",
+                 cbuff
+        );
 
-    if( fd >= 0 ) {
-        if( fd <= INT_MAX ) {
-            cast = (int) fd;
+        return -1; //EARLY RETURN
+    }
 
-        } else {
-            fprintf( stderr,
-                     "[CircularBuffer_memfd_create( \"%s\", %d )] Failed cast long->int (%ld)\n",
-                     name, flags, fd
-            );
+    int reader = -1;
 
-            cast = -1;
+    pthread_mutex_lock( &cbuff->mutex );
+
+    for( int i = 0; i < CIRCULARBUFFER_MAX_READERS && reader < 0; ++i ) {
+        if( !atomic_load_explicit( &cbuff->readers[i].active, memory_order_relaxed ) ) {
+            //new readers start at the oldest data still held in the buffer (a tail moved on meanwhile is caught up with on read)
+            atomic_store_explicit( &cbuff->readers[i].cursor, atomic_load( &cbuff->position.read ), memory_order_relaxed );
+            atomic_store_explicit( &cbuff->readers[i].active, true, memory_order_release );
+            reader = i;
         }
     }
 
-    return cast;
+    pthread_mutex_unlock( &cbuff->mutex );
+
+    if( reader < 0 ) {
+        fprintf( stderr,
+                 "[CircularBuffer_addReader( %p )] Reader registry full (%d).\n",
+                 cbuff, CIRCULARBUFFER_MAX_READERS
+        );
+    }
+
+    return reader;
 }
 
 /**
- * [PRIVATE] Advance the read position
- * @param cbuff Pointer to CircularBuffer_t object
- * @param n     Number of bytes to advance position by
+ * [THREAD-SAFE] Unregisters a broadcast reader (BROADCAST mode)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param reader Reader ID
  */
-static void CircularBuffer_advanceReadPos( CircularBuffer_t * cbuff, size_t n ) {
-    cbuff->position.read = ( ( cbuff->position.read + n ) % cbuff->size );
+static void CircularBuffer_removeReader( CircularBuffer_t * cbuff, int reader ) {
+    if( cbuff == NULL || cbuff->options.mode != CIRCULARBUFFER_MODE_BROADCAST || reader < 0 || reader >= CIRCULARBUFFER_MAX_READERS ) {
+        fprintf( stderr,
+                 "[CircularBuffer_removeReader( %p, %d )] CircularBuffer_t is NULL, not in BROADCAST mode or bad reader ID.\n",
+                 cbuff, reader
+        );
+
+        return; //EARLY RETURN
+    }
+
+    bool active = false;
 
-    if( cbuff->position.read == cbuff->position.write )
-        cbuff->empty = true;
+    pthread_mutex_lock( &cbuff->mutex );
+
+    if( ( active = atomic_load_explicit( &cbuff->readers[reader].active, memory_order_relaxed ) ) )
+        atomic_store_explicit( &cbuff->readers[reader].active, false, memory_order_release );
+
+    pthread_mutex_unlock( &cbuff->mutex );
+
+    if( !active ) {
+        fprintf( stderr,
+                 "[CircularBuffer_removeReader( %p, %d )] Reader is not registered.\n",
+                 cbuff, reader
+        );
+
+        return; //EARLY RETURN
+    }
+
+    CircularBuffer_enterGate( cbuff, &cbuff->gate.consumers );
+    CircularBuffer_updateTail( cbuff );
+    CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+    CircularBuffer_wake( cbuff, &cbuff->parking.producers, &cbuff->space );
 }
 
 /**
- * [PRIVATE] Advance the write position
- * @param cbuff Pointer to CircularBuffer_t object
- * @param n     Number of bytes to advance position by
+ * Reads a chunk as a broadcast reader and copies to a buffer (BROADCAST mode: reader's thread only)
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param reader Reader ID
+ * @param target Target buffer
+ * @param length Length to read and transfer to buffer
+ * @return Actual length read
  */
-static void CircularBuffer_advanceWritePos( CircularBuffer_t * cbuff, size_t n ) {
-    cbuff->position.write = ( ( cbuff->position.write + n ) % cbuff->size );
+static size_t CircularBuffer_readChunkAs( CircularBuffer_t * cbuff, int reader, u_int8_t * target, size_t length ) {
+    if( cbuff == NULL || target == NULL || reader < 0 || reader >= CIRCULARBUFFER_MAX_READERS
+        || !atomic_load_explicit( &cbuff->readers[reader].active, memory_order_relaxed ) )
+    {
+        fprintf( stderr,
+                 "[CircularBuffer_readChunkAs( %p, %d, %p, %lu )] Pointer arg is NULL or reader is not registered.\n",
+                 cbuff, reader, target, length
+        );
+
+        return 0; //EARLY RETURN
+    }
+
+    if( length == 0 ) //nothing to wait for
+        return 0; //EARLY RETURN
+
+    CircularBuffer_Reader_t * slot       = &cbuff->readers[reader];
+    u_int64_t                 read       = 0;
+    u_int64_t                 write      = 0;
+    size_t                    bytes_read = 0;
+    bool                      overrun    = false;
+
+    do {
+        do {
+            read = atomic_load_explicit( &slot->cursor, memory_order_relaxed );
+
+            if( !CircularBuffer_isReadable( cbuff, read, 1 ) ) { //outside the gate: a swap only wakes the wait up early
+                CircularBuffer_wait( cbuff, &cbuff->parking.consumers, &cbuff->ready, CircularBuffer_isReadable, read, 1, NULL );
+            }
+
+            CircularBuffer_enterGate( cbuff, &cbuff->gate.consumers );
+
+            const u_int64_t tail = atomic_load_explicit( &cbuff->position.read, memory_order_acquire );
+
+            if( ( read = atomic_load_explicit( &slot->cursor, memory_order_relaxed ) ) < tail ) { //tail moved on while the reader was registering
+                read = tail;
+            }
+
+            if( ( write = atomic_load_explicit( &cbuff->position.write, memory_order_acquire ) ) == read && length > 0 ) //woken up by a swap
+                CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+        } while( write == read && length > 0 );
 
-    if( n )
-        cbuff->empty = false;
+        const size_t bytes_available = (size_t) ( write - read );
+
+        bytes_read = ( bytes_available < length ? bytes_available : length );
+        CircularBuffer_copyOut( cbuff, target, &cbuff->buffer[CircularBuffer_offset( cbuff, read )], bytes_read );
+        atomic_thread_fence( memory_order_acquire ); //the copy is done before the tail is checked again
+
+        /*
+         * A tail update that scanned the registry before this reader was added can still move the tail past its cursor
+         * after the check above: the producer may then have overwritten the bytes copied, which are read again from the tail
+         */
+        if( ( overrun = ( atomic_load_explicit( &cbuff->position.read, memory_order_relaxed ) > read ) ) )
+            CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+    } while( overrun );
+
+    atomic_store_explicit( &slot->cursor, ( read + bytes_read ), memory_order_release );
+
+    if( bytes_read > 0 )
+        CircularBuffer_updateTail( cbuff );
+
+    CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+
+    if( bytes_read > 0 )
+        CircularBuffer_wake( cbuff, &cbuff->parking.producers, &cbuff->space );
+
+    CircularBuffer_idleTrim( cbuff );
+
+    return bytes_read;
 }
 
 /**
- * Initialises a circular buffer
- * @return Circular buffer object
+ * [PRIVATE] Gives the sides of the buffer owned by an io_uring engine back and resets the engine
+ * @param uring Pointer to CircularBuffer_Uring_t object
+ * @param cbuff Pointer to CircularBuffer_t object served
  */
-static CircularBuffer_t CircularBuffer_create( void ) {
-    return (CircularBuffer_t) {
-        .fd          = 0,
-        .buffer      = NULL,
-        .size        = 0,
-        .mutex       = PTHREAD_MUTEX_INITIALIZER,
-        .ready       = PTHREAD_COND_INITIALIZER,
-        .empty       = true,
-        .position    = { 0, 0 },
-    };
+static void CircularBuffer_uringRelease( CircularBuffer_Uring_t * uring, CircularBuffer_t * cbuff ) {
+    CircularBuffer_Uring_t * producer = uring;
+    CircularBuffer_Uring_t * consumer = uring;
+
+    atomic_compare_exchange_strong( &cbuff->engine.producer, &producer, NULL );
+    atomic_compare_exchange_strong( &cbuff->engine.consumer, &consumer, NULL );
+
+    memset( uring, 0, sizeof( CircularBuffer_Uring_t ) );
+    uring->fd     = -1;
+    uring->source = -1;
+    uring->sink   = -1;
 }
 
 /**
- * [THREAD-SAFE] Initialises the circular buffer
- * @param cbuff Pointer to CircularBuffer_t object
- * @param size  Required size for buffer
+ * Sets up an io_uring engine on an initialised buffer
+ * @param uring  Pointer to CircularBuffer_Uring_t object
+ * @param cbuff  Pointer to CircularBuffer_t object
+ * @param source File descriptor to read into the buffer (-1 for none)
+ * @param sink   File descriptor to write the buffer out to (-1 for none)
+ * @param chunk  Max length in bytes per request (< 1 GiB)
  * @return Success
  */
-static bool CircularBuffer_init( CircularBuffer_t * cbuff, size_t size ) {
-    /*
-     * raw buffer (fd): [##########]
-     *                   |        |
-     *                   |<------>| (n * page size)
-     *                   |        |
-     *  virtual buffer: [##########|##########]
-     *                   ^        ^ ^        ^
-     *                   0        n 0        n
-     *                   |          |
-     *                   section 1  section 2
-     */
-    bool   error_state = false;
-    size_t real_size   = size;
-
-    if( cbuff == NULL ) {
+static bool CircularBuffer_uringInit( CircularBuffer_Uring_t * uring, CircularBuffer_t * cbuff, int source, int sink, size_t chunk ) {
+    if( uring == NULL || cbuff == NULL || cbuff->buffer == NULL || chunk == 0 || chunk >= CIRCULARBUFFER_URING_MAX_BUFFER ) {
         fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] CircularBuffer_t is NULL.\n",
-                 cbuff, size
+                 "[CircularBuffer_uringInit( %p, %p, %i, %i, %lu )] Pointer arg is NULL, buffer not initialised or chunk not in [1, 1 GiB).\n",
+                 uring, cbuff, source, sink, chunk
         );
 
-        error_state = true;
-        goto end;
+        return false; //EARLY RETURN
     }
 
-    pthread_mutex_lock( &cbuff->mutex );
+    const CircularBuffer_Mode_e mode = cbuff->options.mode;
 
-    if( size < 1 || size > LONG_MAX ) {
+    //the engine's requests stay in flight outside of any lock: a range claimed in LOCKED mode is not held off other threads
+    if( mode == CIRCULARBUFFER_MODE_LOCKED
+     || ( source >= 0 && ( mode == CIRCULARBUFFER_MODE_MPSC || mode == CIRCULARBUFFER_MODE_MPMC ) )
+     || ( sink >= 0 && ( mode == CIRCULARBUFFER_MODE_MPMC || mode == CIRCULARBUFFER_MODE_BROADCAST ) ) )
+    {
         fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Bad size (0 > size =< %lu).\n",
-                 cbuff, size, size, LONG_MAX
+                 "[CircularBuffer_uringInit( %p, %p, %i, %i, %lu )] "
+                 "Not available in LOCKED mode, source not available in MPSC/MPMC modes, sink not available in MPMC/BROADCAST modes.\n",
+                 uring, cbuff, source, sink, chunk
         );
 
-        error_state = true;
-        goto end;
+        return false; //EARLY RETURN
     }
 
-    { //calculate the actual min size based on the page size
-        const size_t whole_pages = ( size / getpagesize() ) + ( size % getpagesize() > 0 ? 1 : 0 );
+    CircularBuffer_Uring_t * producer = NULL;
+    CircularBuffer_Uring_t * consumer = NULL;
 
-        real_size = whole_pages * getpagesize();
+    memset( uring, 0, sizeof( CircularBuffer_Uring_t ) );
 
+    if( ( source >= 0 && !atomic_compare_exchange_strong( &cbuff->engine.producer, &producer, uring ) )
+     || ( sink >= 0 && !atomic_compare_exchange_strong( &cbuff->engine.consumer, &consumer, uring ) ) )
+    {
         fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Calculated size: %lu bytes (detected page size: %lu bytes)\n",
-                   cbuff,size, real_size, getpagesize()
+                 "[CircularBuffer_uringInit( %p, %p, %i, %i, %lu )] Another io_uring engine owns a side of the buffer (%p/%p).\n",
+                 uring, cbuff, source, sink, chunk, producer, consumer
         );
+
+        CircularBuffer_uringRelease( uring, cbuff );
+        return false; //EARLY RETURN
     }
 
-    if( ( cbuff->fd = CircularBuffer_memfd_create( "circular_buffer", 0 ) ) < 0 ) {
-        fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Failed to create raw buffer file descriptor: %s\n",
-                 cbuff, size, strerror( errno )
-        );
+    struct io_uring_params params;
 
-        error_state = true;
-        goto end;
-    }
+    memset( &params, 0, sizeof( params ) );
 
-    if( ftruncate( cbuff->fd, real_size ) < 0 ) { //truncate a file to a specified length
+    if( ( uring->fd = CircularBuffer_io_uring_setup( 4, &params ) ) < 0 ) {
         fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Failed to adjust raw buffer size (%lu): %s\n",
-                 cbuff, size, size, strerror( errno )
+                 "[CircularBuffer_uringInit( %p, %p, %i, %i, %lu )] Failed io_uring setup: %s\n",
+                 uring, cbuff, source, sink, chunk, strerror( errno )
         );
 
-        error_state = true;
-        goto end;
+        CircularBuffer_uringRelease( uring, cbuff );
+        return false; //EARLY RETURN
     }
 
-    if( ( cbuff->buffer = mmap( NULL, 2 * real_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) ) == MAP_FAILED ) {
-        fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Failed to map raw buffer: %s\n",
-                 cbuff, size, strerror( errno )
-        );
+    uring->cbuff            = cbuff;
+    uring->source           = source;
+    uring->sink             = sink;
+    uring->ring.sq_length   = ( params.sq_off.array + params.sq_entries * sizeof( u_int32_t ) );
+    uring->ring.cq_length   = ( params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe ) );
+    uring->ring.sqes_length = ( params.sq_entries * sizeof( struct io_uring_sqe ) );
 
-        error_state = true;
-        goto end;
+    if( params.features & IORING_FEAT_SINGLE_MMAP ) { //both rings share a mapping
+        if( uring->ring.cq_length > uring->ring.sq_length )
+            uring->ring.sq_length = uring->ring.cq_length;
+
+        uring->ring.cq_length = 0;
     }
 
-    if( mmap( cbuff->buffer, real_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, cbuff->fd, 0 ) == MAP_FAILED ) {
-        fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Failed to map virtual buffer section 1: %s\n",
-                 cbuff, size, strerror( errno )
-        );
+    u_int8_t * buffer = NULL;
+    size_t     size   = 0;
 
-        error_state = true;
-        goto end;
+    pthread_mutex_lock( &cbuff->mutex ); //pins the mapping before reading it so that `resize(..)` cannot swap it from under the engine
+    atomic_fetch_add( &cbuff->gate.pinned, 1 );
+    buffer = cbuff->buffer;
+    size   = cbuff->size;
+    pthread_mutex_unlock( &cbuff->mutex );
+
+    /*
+     * A range starts below `size` and runs on into the mirror for up to `chunk` bytes so [0, size + chunk) is registered,
+     * in overlapping buffers of at most 1 GiB: buffer `i` covers [i * stride, i * stride + stride + chunk)
+     */
+    uring->chunk  = ( chunk < size ? chunk : size );
+    uring->stride = ( ( size + uring->chunk ) <= CIRCULARBUFFER_URING_MAX_BUFFER ? size : ( CIRCULARBUFFER_URING_MAX_BUFFER - uring->chunk ) );
+
+    const unsigned nr_iov = (unsigned) ( ( size + uring->stride - 1 ) / uring->stride );
+    struct iovec * iov    = calloc( nr_iov, sizeof( struct iovec ) );
+
+    for( unsigned i = 0; iov != NULL && i < nr_iov; ++i ) {
+        const size_t start = ( i * uring->stride );
+        const size_t end   = ( ( start + uring->stride + uring->chunk ) < ( size + uring->chunk ) ? ( start + uring->stride + uring->chunk ) : ( size + uring->chunk ) );
+
+        iov[i] = (struct iovec) { .iov_base = &buffer[start], .iov_len = ( end - start ) };
     }
 
-    if( mmap( ( cbuff->buffer + real_size ), real_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, cbuff->fd, 0 ) == MAP_FAILED ) {
+    if( iov == NULL
+     || ( uring->ring.sq = mmap( NULL, uring->ring.sq_length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING ) ) == MAP_FAILED
+     || ( uring->ring.cq = ( uring->ring.cq_length == 0 ? uring->ring.sq : mmap( NULL, uring->ring.cq_length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING ) ) ) == MAP_FAILED
+     || ( uring->ring.sqes = mmap( NULL, uring->ring.sqes_length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES ) ) == MAP_FAILED
+     || CircularBuffer_io_uring_register( uring->fd, IORING_REGISTER_BUFFERS, iov, nr_iov ) != 0 )
+    {
         fprintf( stderr,
-                 "[CircularBuffer_init( %p, %lu )] Failed to map virtual buffer section 2: %s\n",
-                 cbuff, size, strerror( errno )
+                 "[CircularBuffer_uringInit( %p, %p, %i, %i, %lu )] Failed mapping the rings or registering the buffers: %s\n",
+                 uring, cbuff, source, sink, chunk, strerror( errno )
         );
 
-        error_state = true;
-        goto end;
+        if( uring->ring.sq != NULL && uring->ring.sq != MAP_FAILED )
+            munmap( uring->ring.sq, uring->ring.sq_length );
+        if( uring->ring.cq_length > 0 && uring->ring.cq != NULL && uring->ring.cq != MAP_FAILED )
+            munmap( uring->ring.cq, uring->ring.cq_length );
+        if( uring->ring.sqes != NULL && uring->ring.sqes != MAP_FAILED )
+            munmap( uring->ring.sqes, uring->ring.sqes_length );
+
+        free( iov );
+        atomic_fetch_sub( &cbuff->gate.pinned, 1 );
+        close( uring->fd );
+        CircularBuffer_uringRelease( uring, cbuff );
+
+        return false; //EARLY RETURN
     }
 
-    cbuff->size           = real_size;
-    cbuff->position.write = 0;
-    cbuff->position.read  = 0;
+    free( iov );
 
-    end:
-        pthread_mutex_unlock( &cbuff->mutex );
-        return !( error_state );
+    uring->ring.sq_head  = (_Atomic u_int32_t *) ( (u_int8_t *) uring->ring.sq + params.sq_off.head );
+    uring->ring.sq_tail  = (_Atomic u_int32_t *) ( (u_int8_t *) uring->ring.sq + params.sq_off.tail );
+    uring->ring.sq_array = (u_int32_t *) ( (u_int8_t *) uring->ring.sq + params.sq_off.array );
+    uring->ring.sq_mask  = *(u_int32_t *) ( (u_int8_t *) uring->ring.sq + params.sq_off.ring_mask );
+    uring->ring.cq_head  = (_Atomic u_int32_t *) ( (u_int8_t *) uring->ring.cq + params.cq_off.head );
+    uring->ring.cq_tail  = (_Atomic u_int32_t *) ( (u_int8_t *) uring->ring.cq + params.cq_off.tail );
+    uring->ring.cqes     = ( (u_int8_t *) uring->ring.cq + params.cq_off.cqes );
+    uring->ring.cq_mask  = *(u_int32_t *) ( (u_int8_t *) uring->ring.cq + params.cq_off.ring_mask );
+
+    return true;
 }
 
 /**
- * Writes a chunk to the buffer (no arg checks)
- * @param buffer Pointer to CircularBuffer_t object
- * @param src    Source byte buffer
- * @param length Source length in bytes to copy
- * @return Number or bytes written
+ * [PRIVATE] Queues a fixed buffer read/write request on the submission ring
+ * @param uring  Pointer to CircularBuffer_Uring_t object
+ * @param opcode IORING_OP_READ_FIXED or IORING_OP_WRITE_FIXED
+ * @param fd     File descriptor
+ * @param cursor Start of the buffer range
+ * @param n      Length of the buffer range in bytes
  */
-static size_t CircularBuffer_writeChunk( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length ) {
-    size_t bytes_writen = 0;
+static void CircularBuffer_uringQueue( CircularBuffer_Uring_t * uring, u_int8_t opcode, int fd, u_int64_t cursor, size_t n ) {
+    const u_int32_t        tail  = atomic_load_explicit( uring->ring.sq_tail, memory_order_relaxed ); //only ever moved by this thread
+    const u_int32_t        index = ( tail & uring->ring.sq_mask );
+    struct io_uring_sqe  * sqe   = &( (struct io_uring_sqe *) uring->ring.sqes )[index];
 
-    pthread_mutex_lock( &cbuff->mutex );
+    memset( sqe, 0, sizeof( struct io_uring_sqe ) );
+    sqe->opcode    = opcode;
+    sqe->fd        = fd;
+    sqe->addr      = (u_int64_t) (size_t) &uring->cbuff->buffer[CircularBuffer_offset( uring->cbuff, cursor )];
+    sqe->len       = (u_int32_t) n;
+    sqe->off       = (u_int64_t) -1; //current file position (ignored by pipes/sockets)
+    sqe->buf_index = (u_int16_t) ( CircularBuffer_offset( uring->cbuff, cursor ) / uring->stride );
+    sqe->user_data = opcode;
 
-    size_t free_bytes = ( ( cbuff->position.read + cbuff->size - cbuff->position.write ) % cbuff->size );
+    uring->ring.sq_array[index] = index;
+    atomic_store_explicit( uring->ring.sq_tail, ( tail + 1 ), memory_order_release );
+}
 
-    if( cbuff->empty || length <= free_bytes ) {
-#ifndef NDEBUG
-        size_t old_pos = cbuff->position.write;
-#endif
+/**
+ * [PRIVATE] Queues a cancellation of the request in flight with the given opcode (its `user_data`)
+ * @param uring  Pointer to CircularBuffer_Uring_t object
+ * @param opcode IORING_OP_READ_FIXED or IORING_OP_WRITE_FIXED
+ */
+static void CircularBuffer_uringCancel( CircularBuffer_Uring_t * uring, u_int8_t opcode ) {
+    const u_int32_t        tail  = atomic_load_explicit( uring->ring.sq_tail, memory_order_relaxed );
+    const u_int32_t        index = ( tail & uring->ring.sq_mask );
+    struct io_uring_sqe  * sqe   = &( (struct io_uring_sqe *) uring->ring.sqes )[index];
 
-        memcpy( &cbuff->buffer[cbuff->position.write], src, length );
-        CircularBuffer_advanceWritePos( cbuff, length );
-        bytes_writen = length;
+    memset( sqe, 0, sizeof( struct io_uring_sqe ) );
+    sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    sqe->fd        = -1;
+    sqe->addr      = opcode; //`user_data` of the request to cancel
+    sqe->user_data = IORING_OP_ASYNC_CANCEL;
 
-#ifndef NDEBUG
-        printf( "[CircularBuffer_writeChunk( %p, %p, %lu )] [%ld:'%d'->'%d'] to [%ld/%ld:'%d'->'%d']\n",
-                cbuff, src, length,
-                old_pos, src[0], cbuff->buffer[old_pos],
-                ( old_pos + length ), cbuff->position.write, src[length - 1], cbuff->buffer[old_pos + length - 1] );
-#endif
-        if( length > 0 ) {
-            pthread_cond_signal( &cbuff->ready );
-        }
+    uring->ring.sq_array[index] = index;
+    atomic_store_explicit( uring->ring.sq_tail, ( tail + 1 ), memory_order_release );
+}
 
-    } else {
+/**
+ * Queues a read into the free range and a write out of the readable range (when none are in flight, queue depth 1
+ * per direction: a short read completing ahead of a later one would leave a hole), submits them and advances the
+ * buffer positions with their completions
+ * @param uring Pointer to CircularBuffer_Uring_t object
+ * @param wait  Flag to wait for at least one completion when requests are in flight
+ * @return Number of completions processed (-1 on error: the requests the kernel did not take are submitted by the next call)
+ */
+static int CircularBuffer_uringRun( CircularBuffer_Uring_t * uring, bool wait ) {
+    if( uring == NULL || uring->cbuff == NULL ) {
+        fprintf( stderr, "[CircularBuffer_uringRun( %p, %d )] Engine is NULL or not initialised.\n", uring, wait );
+        return -1; //EARLY RETURN
+    }
+
+    CircularBuffer_t * cbuff   = uring->cbuff;
+    const u_int32_t    max_len = ( uring->chunk < UINT_MAX ? (u_int32_t) uring->chunk : UINT_MAX );
+    size_t             n       = 0;
+    int                count   = 0;
+
+    CircularBuffer_engine = uring; //claims on the sides owned by the engine
+
+    if( uring->source >= 0 && !uring->ingest.active && !uring->eof
+     && ( n = CircularBuffer_claimWrite( cbuff, max_len, true, false, NULL, &uring->ingest.cursor ) ) > 0 )
+    {
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.producers ); //the engine pins the mapping: no swap while it exists
+        CircularBuffer_uringQueue( uring, IORING_OP_READ_FIXED, uring->source, uring->ingest.cursor, n );
+        uring->ingest.active = true;
+    }
+
+    if( uring->sink >= 0 && !uring->drain.active
+     && ( n = CircularBuffer_claimRead( cbuff, max_len, false, NULL, &uring->drain.cursor ) ) > 0 )
+    {
+        CircularBuffer_leaveGate( cbuff, &cbuff->gate.consumers );
+        CircularBuffer_uringQueue( uring, IORING_OP_WRITE_FIXED, uring->sink, uring->drain.cursor, n );
+        uring->drain.active = true;
+    }
+
+    CircularBuffer_engine = NULL;
+
+    //everything the kernel has not taken yet, requests left over by a failed enter included
+    const unsigned queued       = ( atomic_load_explicit( uring->ring.sq_tail, memory_order_relaxed )
+                                  - atomic_load_explicit( uring->ring.sq_head, memory_order_acquire ) );
+    const unsigned min_complete = ( wait && ( uring->ingest.active || uring->drain.active ) ? 1 : 0 );
+
+    if( ( queued > 0 || min_complete > 0 )
+     && CircularBuffer_io_uring_enter( uring->fd, queued, min_complete, ( min_complete > 0 ? IORING_ENTER_GETEVENTS : 0 ) ) < 0
+     && errno != EINTR )
+    {
         fprintf( stderr,
-                 "[CircularBuffer_writeChunk( %p, %p, %lu )] "
-                 "Free space too small (%lu). Consider making the buffer larger (%lu).\n",
-                 cbuff, src, length,
-                 free_bytes, cbuff->size
+                 "[CircularBuffer_uringRun( %p, %d )] Failed io_uring enter: %s\n",
+                 uring, wait, strerror( errno )
         );
+
+        return -1; //EARLY RETURN
     }
 
-    pthread_mutex_unlock( &cbuff->mutex );
+    u_int32_t       head = atomic_load_explicit( uring->ring.cq_head, memory_order_relaxed );
+    const u_int32_t tail = atomic_load_explicit( uring->ring.cq_tail, memory_order_acquire );
 
-    return bytes_writen;
+    for( ; head != tail; ++head, ++count ) {
+        const struct io_uring_cqe * cqe = &( (struct io_uring_cqe *) uring->ring.cqes )[head & uring->ring.cq_mask];
+
+        if( cqe->user_data == IORING_OP_ASYNC_CANCEL ) //the cancelled request completes on its own (-ECANCELED)
+            continue;
+
+        if( cqe->user_data == IORING_OP_READ_FIXED ) { //the claimed range is only published for the bytes read
+            if( cqe->res > 0 )
+                CircularBuffer_publishWrite( cbuff, uring->ingest.cursor, (size_t) cqe->res );
+
+            uring->eof           = ( cqe->res == 0 );
+            uring->ingest.active = false;
+
+        } else {
+            if( cqe->res > 0 )
+                CircularBuffer_publishRead( cbuff, uring->drain.cursor, (size_t) cqe->res );
+
+            uring->drain.active = false;
+        }
+
+        if( cqe->res < 0 && cqe->res != -ECANCELED )
+            uring->error = -cqe->res;
+    }
+
+    atomic_store_explicit( uring->ring.cq_head, head, memory_order_release );
+
+    return count;
 }
 
 /**
- * [THREAD-SAFE] Reads a chunk and copies to a buffer
- * @param cbuff  Pointer to CircularBuffer_t object
- * @param target Target buffer
- * @param length Length to read and transfer to buffer
- * @return Actual length read
+ * Cancels the requests in flight, waits for their completions then tears down the io_uring engine
+ * @param uring Pointer to CircularBuffer_Uring_t object
  */
-static size_t CircularBuffer_readChunk( CircularBuffer_t * cbuff, u_int8_t * target, size_t length ) {
-    if( cbuff == NULL || target == NULL ) {
-        fprintf( stderr,
-                 "[CircularBuffer_readChunk( %p, %p, %lu )] Pointer arg is NULL.\n",
-                 cbuff, target, length
-        );
+static void CircularBuffer_uringFree( CircularBuffer_Uring_t * uring ) {
+    if( uring == NULL || uring->cbuff == NULL )
+        return; //EARLY RETURN
 
-        return 0; //EARLY RETURN
-    }
+    uring->source = -1; //nothing new gets queued
+    uring->sink   = -1;
 
-    int    ret        = 0;
-    size_t bytes_read = 0;
+    //a read on an idle fd (or a write to a stalled one) never completes by itself (done ones are just not found)
+    if( uring->ingest.active )
+        CircularBuffer_uringCancel( uring, IORING_OP_READ_FIXED );
 
-    if( ( ret = pthread_mutex_lock( &cbuff->mutex ) ) == 0 ) {
-        while( cbuff->empty ) {
-            pthread_cond_wait( &cbuff->ready, &cbuff->mutex );
-        }
+    if( uring->drain.active )
+        CircularBuffer_uringCancel( uring, IORING_OP_WRITE_FIXED );
 
-        size_t bytes_available = ( ( cbuff->position.write + cbuff->size ) - cbuff->position.read ) % cbuff->size;
-#ifndef NDEBUG
-        size_t old_pos = cbuff->position.read;
-#endif
-        bytes_read = ( bytes_available < length ? bytes_available : length );
-        memcpy( target, &cbuff->buffer[cbuff->position.read], bytes_read );
-        CircularBuffer_advanceReadPos( cbuff, bytes_read );
+    while( ( uring->ingest.active || uring->drain.active ) && CircularBuffer_uringRun( uring, true ) >= 0 );
 
-#ifndef NDEBUG
-        printf( "[CircularBuffer_readChunk( %p, %p, %lu )] [%ld:'%d'] to [%ld/%ld:'%d']   (w: %ld, avail: %lu)\n",
-                cbuff, target, length,
-                old_pos, cbuff->buffer[old_pos],
-                (old_pos + bytes_read), (cbuff->position.read), cbuff->buffer[(old_pos + bytes_read) - 1],
-                cbuff->position.write, bytes_available);
-#endif
-        if( ( ret = pthread_mutex_unlock( &cbuff->mutex ) ) != 0 ) {
-            fprintf( stderr,
-                     "[CircularBuffer_readChunk( %p, %p, %lu )] Failed to unlock mutex: %s (%d).\n",
-                     cbuff, target, length, CircularBuffer_getPThreadErrStr( ret ), ret
-            );
-        }
+    munmap( uring->ring.sqes, uring->ring.sqes_length );
 
-    } else {
+    if( uring->ring.cq_length > 0 )
+        munmap( uring->ring.cq, uring->ring.cq_length );
+
+    munmap( uring->ring.sq, uring->ring.sq_length );
+
+    if( close( uring->fd ) != 0 ) { //also drops the fixed buffer registration
         fprintf( stderr,
-                 "[CircularBuffer_readChunk( %p, %p, %lu )] Failed to lock mutex: %s (%d).\n",
-                 cbuff, target, length, CircularBuffer_getPThreadErrStr( ret ), ret
+                 "[CircularBuffer_uringFree( %p )] Failed close file descriptor: %s\n",
+                 uring, strerror( errno )
         );
     }
 
-    return bytes_read;
+    atomic_fetch_sub( &uring->cbuff->gate.pinned, 1 );
+    CircularBuffer_uringRelease( uring, uring->cbuff );
 }
 
 /**
@@ -323,14 +3262,50 @@ static bool CircularBuffer_empty( CircularBuffer_t * cbuff ) {
     bool empty = true;
 
     if( cbuff != NULL ) {
-        pthread_mutex_lock( &cbuff->mutex );
-        empty = cbuff->empty;
-        pthread_mutex_unlock( &cbuff->mutex );
+        empty = ( atomic_load_explicit( &cbuff->position.read, memory_order_acquire )
+               == atomic_load_explicit( &cbuff->position.write, memory_order_acquire ) );
     }
 
     return empty;
 }
 
+/**
+ * [THREAD-SAFE] Gets the buffer's statistics
+ * @param cbuff Pointer to CircularBuffer_t object (NULL for the process wide ones only)
+ * @return Statistics
+ */
+static CircularBuffer_Stats_t CircularBuffer_stats( CircularBuffer_t * cbuff ) {
+    pthread_once( &CircularBuffer_copyKernelOnce, CircularBuffer_selectCopyKernel );
+
+    CircularBuffer_Stats_t stats = {
+        .copy_kernel        = CircularBuffer_copyKernels[( cbuff != NULL ? cbuff->options.copy_kernel : CIRCULARBUFFER_COPY_AUTO )].name,
+        .crc_kernel         = CircularBuffer_crcKernel.name,
+        .size               = 0,
+        .used               = 0,
+        .page_size          = 0,
+        .huge_page_fallback = false,
+        .numa_node          = -1,
+        .resident           = 0,
+    };
+
+    if( cbuff != NULL ) {
+        struct stat     st;
+        const u_int64_t read  = atomic_load_explicit( &cbuff->position.read, memory_order_acquire );
+        const u_int64_t write = atomic_load_explicit( &cbuff->position.write, memory_order_acquire );
+
+        stats.size               = cbuff->size;
+        stats.used               = ( write > read ? (size_t) ( write - read ) : 0 );
+        stats.page_size          = cbuff->page_size;
+        stats.huge_page_fallback = ( cbuff->options.huge_page_size > 0 && cbuff->page_size < cbuff->options.huge_page_size );
+        stats.numa_node          = cbuff->numa_node;
+
+        if( cbuff->buffer != NULL && fstat( cbuff->fd, &st ) == 0 )
+            stats.resident = (size_t) st.st_blocks * 512;
+    }
+
+    return stats;
+}
+
 /**
  * Gets the current buffer size
  * @param cbuff Pointer to CircularBuffer_t object
@@ -381,10 +3356,17 @@ static void CircularBuffer_free( CircularBuffer_t * cbuff ) {
 
         pthread_mutex_destroy( &cbuff->mutex );
         pthread_cond_destroy( &cbuff->ready );
-        cbuff->fd             = 0;
-        cbuff->buffer         = NULL;
-        cbuff->position.read  = 0;
-        cbuff->position.write = 0;
+        pthread_cond_destroy( &cbuff->space );
+        cbuff->fd     = 0;
+        cbuff->buffer = NULL;
+        atomic_store( &cbuff->position.read, 0 );
+        atomic_store( &cbuff->position.write, 0 );
+        atomic_store( &cbuff->position.write_claim, 0 );
+        atomic_store( &cbuff->position.read_claim, 0 );
+
+        for( size_t i = 0; i < CIRCULARBUFFER_MAX_READERS; ++i ) {
+            atomic_store( &cbuff->readers[i].active, false );
+        }
     }
 }
 
@@ -392,11 +3374,35 @@ static void CircularBuffer_free( CircularBuffer_t * cbuff ) {
  * Namespace constructor
  */
 const struct CircularBuffer_Namespace CircularBuffer = {
-    .create     = &CircularBuffer_create,
-    .init       = &CircularBuffer_init,
-    .writeChunk = &CircularBuffer_writeChunk,
-    .readChunk  = &CircularBuffer_readChunk,
-    .size       = &CircularBuffer_size,
-    .empty      = &CircularBuffer_empty,
-    .free       = &CircularBuffer_free,
+    .create          = &CircularBuffer_create,
+    .init            = &CircularBuffer_init,
+    .resize          = &CircularBuffer_resize,
+    .trim            = &CircularBuffer_trim,
+    .writeChunk      = &CircularBuffer_writeChunk,
+    .writeChunkUntil = &CircularBuffer_writeChunkUntil,
+    .writeSome       = &CircularBuffer_writeSome,
+    .writeChunkCrc   = &CircularBuffer_writeChunkCrc,
+    .writeChunkV     = &CircularBuffer_writeChunkV,
+    .reserveWrite    = &CircularBuffer_reserveWrite,
+    .commitWrite     = &CircularBuffer_commitWrite,
+    .writeFromFd     = &CircularBuffer_writeFromFd,
+    .spliceFromPipe  = &CircularBuffer_spliceFromPipe,
+    .readChunk       = &CircularBuffer_readChunk,
+    .readChunkUntil  = &CircularBuffer_readChunkUntil,
+    .tryReadChunk    = &CircularBuffer_tryReadChunk,
+    .readChunkCrc    = &CircularBuffer_readChunkCrc,
+    .readChunkV      = &CircularBuffer_readChunkV,
+    .peekRead        = &CircularBuffer_peekRead,
+    .consume         = &CircularBuffer_consume,
+    .readToFd        = &CircularBuffer_readToFd,
+    .addReader       = &CircularBuffer_addReader,
+    .removeReader    = &CircularBuffer_removeReader,
+    .readChunkAs     = &CircularBuffer_readChunkAs,
+    .uringInit       = &CircularBuffer_uringInit,
+    .uringRun        = &CircularBuffer_uringRun,
+    .uringFree       = &CircularBuffer_uringFree,
+    .size            = &CircularBuffer_size,
+    .empty           = &CircularBuffer_empty,
+    .stats           = &CircularBuffer_stats,
+    .free            = &CircularBuffer_free,
 };
\ No newline at end of file
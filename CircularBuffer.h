@@ -3,34 +3,290 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <pthread.h>
+#include <time.h>
+#include <sys/uio.h>
+
+#define CIRCULARBUFFER_CACHELINE   64
+#define CIRCULARBUFFER_MAX_READERS 16
+
+/**
+ * CircularBuffer concurrency modes
+ * - LOCKED   : any number of producer/consumer threads, every access is serialised on the mutex
+ * - SPSC     : 1 producer and 1 consumer thread, lock-free positions (mutex only used to park the consumer)
+ * - MPSC     : N producer and 1 consumer thread, producers claim ranges lock-free and publish them in claim order
+ * - MPMC     : N producer and N consumer threads, consumers also claim ranges lock-free and release them in claim order
+ * - BROADCAST: 1 producer and N registered readers that each see the whole stream through their own cursor
+ */
+typedef enum CircularBuffer_Mode {
+    CIRCULARBUFFER_MODE_LOCKED = 0,
+    CIRCULARBUFFER_MODE_SPSC,
+    CIRCULARBUFFER_MODE_MPSC,
+    CIRCULARBUFFER_MODE_MPMC,
+    CIRCULARBUFFER_MODE_BROADCAST,
+} CircularBuffer_Mode_e;
+
+/**
+ * CircularBuffer parking methods for waiting threads
+ * - CONDITION: pthread condition variable (takes the mutex)
+ * - FUTEX    : raw futex word (no mutex)
+ */
+typedef enum CircularBuffer_Park {
+    CIRCULARBUFFER_PARK_CONDITION = 0,
+    CIRCULARBUFFER_PARK_FUTEX,
+} CircularBuffer_Park_e;
+
+/**
+ * CircularBuffer NUMA placement policies for the buffer's pages
+ * - NONE      : pages land on the node of the first thread touching them
+ * - BIND      : pages are bound to the node of `options.numa_cpu`
+ * - INTERLEAVE: pages are interleaved over all online nodes
+ */
+typedef enum CircularBuffer_Numa {
+    CIRCULARBUFFER_NUMA_NONE = 0,
+    CIRCULARBUFFER_NUMA_BIND,
+    CIRCULARBUFFER_NUMA_INTERLEAVE,
+} CircularBuffer_Numa_e;
+
+/**
+ * CircularBuffer copy kernels for the chunks copied in and out of the buffer
+ * - LIBC  : libc `memcpy` (its own CPU dispatch beats the kernels below on cached chunks)
+ * - AUTO  : widest of the kernels below the host CPU supports
+ * - SSE2  : 16 byte vectors
+ * - AVX2  : 32 byte vectors
+ * - AVX512: 64 byte vectors
+ */
+typedef enum CircularBuffer_Copy {
+    CIRCULARBUFFER_COPY_LIBC = 0,
+    CIRCULARBUFFER_COPY_AUTO,
+    CIRCULARBUFFER_COPY_SSE2,
+    CIRCULARBUFFER_COPY_AVX2,
+    CIRCULARBUFFER_COPY_AVX512,
+} CircularBuffer_Copy_e;
+
+/**
+ * CircularBuffer wait strategy (lock-free modes): spin, then yield, then park
+ * @param spins  Busy-spin iterations (with a CPU pause instruction)
+ * @param yields `sched_yield()` iterations once done spinning
+ * @param park   Parking method once done yielding
+ */
+typedef struct CircularBuffer_WaitStrategy {
+    unsigned              spins;
+    unsigned              yields;
+    CircularBuffer_Park_e park;
+} CircularBuffer_WaitStrategy_t;
+
+/**
+ * CircularBuffer options (to set after `create()` and before `init(..)`)
+ * @param mode             Concurrency mode
+ * @param power_of_two     Rounds the size up to a power of 2 so that offsets are masked instead of divided
+ * @param blocking_write   Writers wait for enough free space (back-pressure) instead of dropping the chunk
+ * @param wake_threshold   Min pending bytes before parked consumers are woken (0: any); a parked consumer can
+ *                         sleep on fewer bytes until more data comes in (use `readChunkUntil(..)` to bound the latency)
+ * @param wait             Wait strategy for blocked threads (ignored in LOCKED mode)
+ * @param stream_threshold Min chunk length in bytes written with non-temporal stores that bypass the producer's caches
+ *                         (0: never); worth it when the consumer runs on another core and chunks are large
+ * @param copy_kernel      Copy kernel for the other chunks (default: libc); one the CPU lacks falls back to libc,
+ *                         benchmark before overriding (`circular_buffer_benchmark copy`)
+ * @param huge_page_size   Huge page size backing the buffer (0: none, e.g. 2 MiB or 1 GiB); the size is rounded up to it
+ *                         and falls back to normal pages when the system has none available (see `stats(..)`)
+ * @param numa             NUMA placement policy for the buffer's pages (applied before they are first touched)
+ * @param numa_cpu         CPU whose node the pages are bound to with the BIND policy (-1: CPU calling `init(..)`)
+ * @param prefault         Populates all the pages (and both mirror page tables) in `init(..)` so the first lap takes no page faults
+ * @param lock_pages       Locks the pages in memory (mlock) so they cannot be swapped out (needs RLIMIT_MEMLOCK headroom)
+ * @param resizable        Enables `resize(..)` in the lock-free modes: operations then check in and out of a gate that the
+ *                         swap closes (LOCKED mode always can, the mutex is its gate)
+ * @param trim_keep        Free bytes that `trim(..)` keeps resident ahead of the write position (rounded up to whole pages)
+ * @param trim_interval    Idle time in ms after which a consumer call trims the buffer (0: never): no more than `trim_keep`
+ *                         bytes published over the whole interval; lock-free modes need `options.resizable`, and neither
+ *                         `prefault` nor `lock_pages` buffers are trimmed
+ */
+typedef struct CircularBuffer_Options {
+    CircularBuffer_Mode_e         mode;
+    bool                          power_of_two;
+    bool                          blocking_write;
+    size_t                        wake_threshold;
+    CircularBuffer_WaitStrategy_t wait;
+    size_t                        stream_threshold;
+    CircularBuffer_Copy_e         copy_kernel;
+    size_t                        huge_page_size;
+    CircularBuffer_Numa_e         numa;
+    int                           numa_cpu;
+    bool                          prefault;
+    bool                          lock_pages;
+    bool                          resizable;
+    size_t                        trim_keep;
+    unsigned                      trim_interval;
+} CircularBuffer_Options_t;
+
+/**
+ * CircularBuffer parking spot
+ * @param futex   Futex word (bumped on every wake-up)
+ * @param waiters Number of parked threads
+ */
+typedef struct CircularBuffer_Parking {
+    _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int32_t futex;
+    _Atomic u_int32_t waiters;
+} CircularBuffer_Parking_t;
+
+/**
+ * CircularBuffer broadcast reader slot
+ * @param cursor Reader's own read cursor
+ * @param active Slot in use flag
+ */
+typedef struct CircularBuffer_Reader {
+    _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int64_t cursor;
+    atomic_bool active;
+} CircularBuffer_Reader_t;
 
 /**
  * CircularBuffer object
  * @param mutex      Mutex for read/write locks
  * @param ready      Read access condition
- * @param empty      Empty state of the buffer
- * @param position   Read/Write positions
+ * @param space      Write access condition (blocking writes)
+ * @param options    Buffer options
+ * @param parking    Parking spots for waiting threads (lock-free modes)
+ * @param position   Monotonic read/write cursors and their claim cursors (each on its own cache line, occupancy = write - read,
+ *                   LOCKED mode: a claim cursor past its position marks a range filled/drained outside the mutex)
+ * @param readers    Broadcast reader registry (BROADCAST mode, `position.read` tracks the slowest reader)
  * @param fd         File descriptor for the virtual buffer
  * @param buffer     Raw buffer
  * @param size       Total size of the buffer
+ * @param mask       Offset mask (`size - 1`) when the size is a power of 2, 0 otherwise
+ * @param page_size  Size of the pages backing the buffer
+ * @param numa_node  Node the pages are bound to (BIND policy), -1 otherwise
+ * @param trimmed    Start of the current idle window, reset by trims (CLOCK_MONOTONIC ns)
+ * @param trim_mark  Write position at the start of the current idle window
+ * @param gate       Resize gate: resize in progress flag, swap flag (futex word), threads parked on it, mapping pins
+ *                   (io_uring engines and fd transfers in flight) and operations in flight on each side (`options.resizable`)
+ * @param engine     io_uring engines owning the producer/consumer side (NULL for none)
  */
 typedef struct CircularBuffer {
     pthread_mutex_t mutex;
     pthread_cond_t  ready;
-    bool            empty;
+    pthread_cond_t  space;
+
+    CircularBuffer_Options_t options;
 
     struct {
-        size_t read;
-        size_t write;
+        CircularBuffer_Parking_t consumers;
+        CircularBuffer_Parking_t producers;
+    } parking;
+
+    struct {
+        _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int64_t read;
+        _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int64_t write;
+        _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int64_t read_claim;
+        _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int64_t write_claim;
     } position;
 
-    int             fd;
-    u_int8_t      * buffer;
-    size_t          size;
+    CircularBuffer_Reader_t readers[CIRCULARBUFFER_MAX_READERS];
+
+    _Alignas( CIRCULARBUFFER_CACHELINE )
+    int               fd;
+    u_int8_t        * buffer;
+    size_t            size;
+    size_t            mask;
+    size_t            page_size;
+    int               numa_node;
+    _Atomic u_int64_t trimmed;
+    _Atomic u_int64_t trim_mark;
+
+    struct {
+        atomic_bool       resizing;
+        _Atomic u_int32_t closed;
+        _Atomic u_int32_t waiters;
+        _Atomic u_int32_t pinned;
+        _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int32_t producers;
+        _Alignas( CIRCULARBUFFER_CACHELINE ) _Atomic u_int32_t consumers;
+    } gate;
+
+    struct {
+        struct CircularBuffer_Uring * _Atomic producer;
+        struct CircularBuffer_Uring * _Atomic consumer;
+    } engine;
 
 } CircularBuffer_t;
 
+/**
+ * CircularBuffer statistics
+ * @param copy_kernel        Copy kernel used by the buffer ("libc", "sse2", "avx2" or "avx512"), what AUTO picks without one
+ * @param crc_kernel         CRC32C kernel selected for the host CPU at startup ("sse4.2+pclmul", "sse4.2" or "table")
+ * @param size               Size of the buffer in bytes
+ * @param used               Bytes currently held in the buffer
+ * @param page_size          Size of the pages backing the buffer
+ * @param huge_page_fallback Huge pages were asked for but unavailable (normal pages are used instead)
+ * @param numa_node          Node the pages are bound to (BIND policy), -1 otherwise
+ * @param resident           Bytes of the raw buffer held in memory (what `trim(..)` releases)
+ */
+typedef struct CircularBuffer_Stats {
+    const char * copy_kernel;
+    const char * crc_kernel;
+    size_t       size;
+    size_t       used;
+    size_t       page_size;
+    bool         huge_page_fallback;
+    int          numa_node;
+    size_t       resident;
+} CircularBuffer_Stats_t;
+
+/**
+ * CircularBuffer io_uring engine: reads from a source into the free range and writes the readable range out to a sink,
+ * with the buffer's mirrored mapping registered as fixed buffers (raw syscalls, no liburing).
+ * The engine is the buffer's only producer when given a source and its only consumer when given a sink: the other
+ * operations of that side fail while it is set up.
+ * Queue depth is 1 per direction: at most one read and one write are in flight (a single `io_uring_enter(2)` submits
+ * both and reaps their completions). Stream fds (pipes, sockets) complete queued reads in no set order and a short one
+ * would leave a hole in the buffer, so deeper queues are not used: the engine saves syscalls, not latency, and a
+ * request is only as large as `chunk`.
+ * @param cbuff   Pointer to the CircularBuffer_t object served
+ * @param fd      io_uring file descriptor
+ * @param source  File descriptor read into the buffer (-1 for none)
+ * @param sink    File descriptor written from the buffer (-1 for none)
+ * @param chunk   Max length in bytes per request
+ * @param stride  Buffer offsets served by each registered buffer (the kernel caps one at 1 GiB, the ranges starting
+ *                in `[i * stride, (i + 1) * stride)` are all held by registered buffer `i`)
+ * @param eof     Flag set when the source reached end-of-file
+ * @param error   errno of the last failed request (0 for none)
+ * @param ring    Mapped submission/completion rings
+ * @param ingest  Read request in flight (range of the buffer being filled)
+ * @param drain   Write request in flight (range of the buffer being sent)
+ */
+typedef struct CircularBuffer_Uring {
+    CircularBuffer_t * cbuff;
+    int                fd;
+    int                source;
+    int                sink;
+    size_t             chunk;
+    size_t             stride;
+    bool               eof;
+    int                error;
+
+    struct {
+        void              * sq;
+        size_t              sq_length;
+        void              * cq;
+        size_t              cq_length;
+        void              * sqes;
+        size_t              sqes_length;
+        _Atomic u_int32_t * sq_head;
+        _Atomic u_int32_t * sq_tail;
+        u_int32_t         * sq_array;
+        u_int32_t           sq_mask;
+        _Atomic u_int32_t * cq_head;
+        _Atomic u_int32_t * cq_tail;
+        void              * cqes;
+        u_int32_t           cq_mask;
+    } ring;
+
+    struct {
+        bool      active;
+        u_int64_t cursor;
+    } ingest, drain;
+
+} CircularBuffer_Uring_t;
+
 /**
  * CircularBuffer namespace
  */
@@ -50,16 +306,122 @@ extern const struct CircularBuffer_Namespace {
     bool (* init)( CircularBuffer_t * cbuff, size_t size );
 
     /**
-     * [THREAD-SAFE] Writes a chunk to the buffer
+     * [THREAD-SAFE] Grows the buffer in use without losing its content (producers and consumers are only held off
+     * for the swap). Lock-free modes need `options.resizable`; waits for the pending reservations of other threads.
+     * Fails while an io_uring engine is set up on the buffer or, in lock-free modes, a writeFromFd/spliceFromPipe/readToFd
+     * syscall is in flight.
+     * @param cbuff Pointer to CircularBuffer_t object
+     * @param size  New required size for buffer (> current size)
+     * @return Success
+     */
+    bool (* resize)( CircularBuffer_t * cbuff, size_t size );
+
+    /**
+     * [THREAD-SAFE] Releases the pages of the buffer's free range but `options.trim_keep` bytes ahead of the write
+     * position, so that the memory held drops back to about the data size (producers are held off meanwhile).
+     * Same conditions as `resize(..)` and not available with `options.prefault` or `options.lock_pages`.
+     * @param cbuff Pointer to CircularBuffer_t object
+     * @return Success
+     */
+    bool (* trim)( CircularBuffer_t * cbuff );
+
+    /**
+     * [THREAD-SAFE] Writes a chunk to the buffer (SPSC/BROADCAST modes: producer thread only)
      * @param cbuff  Pointer to CircularBuffer_t object
      * @param src    Source byte buffer
      * @param length Source length in bytes to copy
-     * @return Number or bytes written
+     * @return Number or bytes written (0 when there is not enough free space and writes are not blocking)
      */
     size_t (* writeChunk)( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length );
 
     /**
-     * [THREAD-SAFE] Reads a chunk and copies to a buffer
+     * [THREAD-SAFE] Writes a chunk to the buffer, waiting for enough free space up to a deadline (SPSC/BROADCAST modes: producer thread only)
+     * @param cbuff    Pointer to CircularBuffer_t object
+     * @param src      Source byte buffer
+     * @param length   Source length in bytes to copy
+     * @param deadline Absolute CLOCK_MONOTONIC deadline
+     * @return Number or bytes written (0 if the deadline was reached)
+     */
+    size_t (* writeChunkUntil)( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length, const struct timespec * deadline );
+
+    /**
+     * [THREAD-SAFE] Writes as much of a chunk as currently fits in the buffer without waiting (SPSC/BROADCAST modes: producer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param src    Source byte buffer
+     * @param length Source length in bytes to copy
+     * @return Number or bytes written (min(length, free space))
+     */
+    size_t (* writeSome)( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length );
+
+    /**
+     * [THREAD-SAFE] Writes a chunk to the buffer, updating a running CRC32C with it while copying (SPSC/BROADCAST modes: producer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param src    Source byte buffer
+     * @param length Source length in bytes to copy
+     * @param crc    Pointer to running CRC32C (0 to start)
+     * @return Number or bytes written
+     */
+    size_t (* writeChunkCrc)( CircularBuffer_t * cbuff, const u_int8_t * src, size_t length, u_int32_t * crc );
+
+    /**
+     * [THREAD-SAFE] Writes a set of segments to the buffer as one chunk, published at once (all or nothing)
+     * (SPSC/BROADCAST modes: producer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param iov    Source segments
+     * @param iovcnt Number of segments
+     * @return Number or bytes written (0 or the sum of the segment lengths)
+     */
+    size_t (* writeChunkV)( CircularBuffer_t * cbuff, const struct iovec * iov, int iovcnt );
+
+    /**
+     * [THREAD-SAFE] Reserves a contiguous range at the write position to encode into in place
+     * (LOCKED mode: the mutex is held until `commitWrite(..)`, SPSC/BROADCAST modes: producer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param length Length in bytes to reserve
+     * @return Pointer to the reserved range in the buffer (NULL on failure or not enough free space)
+     */
+    u_int8_t * (* reserveWrite)( CircularBuffer_t * cbuff, size_t length );
+
+    /**
+     * [THREAD-SAFE] Publishes the calling thread's `reserveWrite(..)` range
+     * (LOCKED/SPSC/BROADCAST modes: any start of the range, 0 cancelling the reservation;
+     * MPSC/MPMC modes: other producers may have claimed after the reservation so only the whole range is published,
+     * a shorter length (0 included) is refused and leaves the reservation pending: it cannot be cancelled)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param length Length in bytes to publish (=< reserved length)
+     * @return Number of bytes published (0 when refused)
+     */
+    size_t (* commitWrite)( CircularBuffer_t * cbuff, size_t length );
+
+    /**
+     * [THREAD-SAFE] Reads from a file descriptor straight into the free range at the write position
+     * (LOCKED mode: the range is claimed under the mutex and read(2) into without it, other producers wait for it,
+     * SPSC/BROADCAST modes: producer thread only, the mapping is pinned for the read(2) instead of resize/trim held off,
+     * not available in MPSC/MPMC modes)
+     * @param cbuff Pointer to CircularBuffer_t object
+     * @param fd    File descriptor to read from (file, pipe, socket, ...)
+     * @param max   Max length in bytes to read
+     * @return Number of bytes written to the buffer, 0 on end-of-file or -1 on error (errno set, ENOBUFS when full or,
+     *         without `options.blocking_write`, when another producer's range is being read into)
+     */
+    ssize_t (* writeFromFd)( CircularBuffer_t * cbuff, int fd, size_t max );
+
+    /**
+     * [THREAD-SAFE] Splices from a pipe straight into the buffer's memfd at the write position (no user-space copy;
+     * huge page buffers fall back to read(2) as hugetlbfs does not support splice(2) writes)
+     * (LOCKED mode: the range is claimed under the mutex and spliced into without it, other producers wait for it,
+     * SPSC/BROADCAST modes: producer thread only, the mapping is pinned for the splice(2) instead of resize/trim held off,
+     * not available in MPSC/MPMC modes)
+     * @param cbuff   Pointer to CircularBuffer_t object
+     * @param pipe_fd Read end of a pipe
+     * @param max     Max length in bytes to splice (capped to the end of the memfd)
+     * @return Number of bytes written to the buffer, 0 when the pipe's write end is closed or -1 on error (errno set, ENOBUFS when full
+     *         or, without `options.blocking_write`, when another producer's range is being spliced into)
+     */
+    ssize_t (* spliceFromPipe)( CircularBuffer_t * cbuff, int pipe_fd, size_t max );
+
+    /**
+     * [THREAD-SAFE] Reads a chunk and copies to a buffer (SPSC/MPSC modes: consumer thread only)
      * @param cbuff  Pointer to CircularBuffer_t object
      * @param target Target buffer
      * @param length Length to read and transfer to buffer
@@ -67,6 +429,128 @@ extern const struct CircularBuffer_Namespace {
      */
     size_t (* readChunk)( CircularBuffer_t * cbuff, u_int8_t * target, size_t length );
 
+    /**
+     * [THREAD-SAFE] Reads a chunk and copies to a buffer, waiting for data up to a deadline (SPSC/MPSC modes: consumer thread only)
+     * @param cbuff    Pointer to CircularBuffer_t object
+     * @param target   Target buffer
+     * @param length   Length to read and transfer to buffer
+     * @param deadline Absolute CLOCK_MONOTONIC deadline
+     * @return Actual length read (0 if the deadline was reached)
+     */
+    size_t (* readChunkUntil)( CircularBuffer_t * cbuff, u_int8_t * target, size_t length, const struct timespec * deadline );
+
+    /**
+     * [THREAD-SAFE] Reads a chunk and copies to a buffer without waiting when the buffer is empty (SPSC/MPSC modes: consumer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param target Target buffer
+     * @param length Length to read and transfer to buffer
+     * @return Actual length read (0 when empty)
+     */
+    size_t (* tryReadChunk)( CircularBuffer_t * cbuff, u_int8_t * target, size_t length );
+
+    /**
+     * [THREAD-SAFE] Reads a chunk and copies to a buffer, updating a running CRC32C with it while copying (SPSC/MPSC modes: consumer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param target Target buffer
+     * @param length Length to read and transfer to buffer
+     * @param crc    Pointer to running CRC32C (0 to start)
+     * @return Actual length read
+     */
+    size_t (* readChunkCrc)( CircularBuffer_t * cbuff, u_int8_t * target, size_t length, u_int32_t * crc );
+
+    /**
+     * [THREAD-SAFE] Reads a chunk and scatters it over a set of segments, waiting for data when empty
+     * (SPSC/MPSC modes: consumer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param iov    Target segments (filled in order)
+     * @param iovcnt Number of segments
+     * @return Actual length read (=< sum of the segment lengths)
+     */
+    size_t (* readChunkV)( CircularBuffer_t * cbuff, const struct iovec * iov, int iovcnt );
+
+    /**
+     * [THREAD-SAFE] Gets the readable range at the read position to work on in place, waiting for data when empty
+     * (LOCKED mode: the mutex is held until `consume(..)`, SPSC/MPSC modes: consumer thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param length Pointer to variable to set to the length of the readable range
+     * @return Pointer to the readable range in the buffer (NULL on failure)
+     */
+    const u_int8_t * (* peekRead)( CircularBuffer_t * cbuff, size_t * length );
+
+    /**
+     * [THREAD-SAFE] Releases the start of the calling thread's `peekRead(..)` range back to the producer(s)
+     * (MPMC mode: other consumers may have claimed after the peeked range so it is only consumed whole,
+     * a shorter length is refused and leaves the peek pending)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param length Length in bytes to consume (=< peeked length)
+     * @return Number of bytes consumed (0 when refused)
+     */
+    size_t (* consume)( CircularBuffer_t * cbuff, size_t length );
+
+    /**
+     * [THREAD-SAFE] Writes the readable range at the read position straight to a file descriptor, waiting for data when empty
+     * (LOCKED mode: the range is claimed under the mutex and written out without it, other consumers wait for it,
+     * SPSC/MPSC modes: consumer thread only, the mapping is pinned for the write(2) instead of resize/trim held off,
+     * not available in MPMC/BROADCAST modes)
+     * @param cbuff Pointer to CircularBuffer_t object
+     * @param fd    File descriptor to write to (file, pipe, socket, ...)
+     * @param max   Max length in bytes to write
+     * @return Number of bytes accepted by the kernel (and consumed from the buffer) or -1 on error (errno set)
+     */
+    ssize_t (* readToFd)( CircularBuffer_t * cbuff, int fd, size_t max );
+
+    /**
+     * [THREAD-SAFE] Registers a broadcast reader (BROADCAST mode)
+     * @param cbuff Pointer to CircularBuffer_t object
+     * @return Reader ID (-1 on failure)
+     */
+    int (* addReader)( CircularBuffer_t * cbuff );
+
+    /**
+     * [THREAD-SAFE] Unregisters a broadcast reader (BROADCAST mode)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param reader Reader ID
+     */
+    void (* removeReader)( CircularBuffer_t * cbuff, int reader );
+
+    /**
+     * Reads a chunk as a broadcast reader and copies to a buffer (BROADCAST mode: reader's thread only)
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param reader Reader ID
+     * @param target Target buffer
+     * @param length Length to read and transfer to buffer
+     * @return Actual length read
+     */
+    size_t (* readChunkAs)( CircularBuffer_t * cbuff, int reader, u_int8_t * target, size_t length );
+
+    /**
+     * Sets up an io_uring engine on an initialised buffer (not in LOCKED mode, source: not in MPSC/MPMC modes,
+     * sink: not in MPMC/BROADCAST modes, one engine per side)
+     * @param uring  Pointer to CircularBuffer_Uring_t object
+     * @param cbuff  Pointer to CircularBuffer_t object
+     * @param source File descriptor to read into the buffer (-1 for none)
+     * @param sink   File descriptor to write the buffer out to (-1 for none)
+     * @param chunk  Max length in bytes per request (< 1 GiB, capped to the buffer's size)
+     * @return Success
+     */
+    bool (* uringInit)( CircularBuffer_Uring_t * uring, CircularBuffer_t * cbuff, int source, int sink, size_t chunk );
+
+    /**
+     * Queues a read into the free range and a write out of the readable range (when none are in flight, queue depth 1
+     * per direction), submits them and advances the buffer positions with their completions (engine's thread only)
+     * @param uring Pointer to CircularBuffer_Uring_t object
+     * @param wait  Flag to wait for at least one completion when requests are in flight
+     * @return Number of completions processed (-1 on error: the requests the kernel did not take are submitted by the next call)
+     */
+    int (* uringRun)( CircularBuffer_Uring_t * uring, bool wait );
+
+    /**
+     * Cancels the requests in flight, waits for their completions then tears down the io_uring engine (the buffer is
+     * left as is: the ranges of cancelled requests are never published)
+     * @param uring Pointer to CircularBuffer_Uring_t object
+     */
+    void (* uringFree)( CircularBuffer_Uring_t * uring );
+
     /**
      * [THREAD-SAFE] Gets the current buffer size
      * @param cbuff Pointer to CircularBuffer_t object
@@ -81,6 +565,13 @@ extern const struct CircularBuffer_Namespace {
      */
     bool (* empty)( CircularBuffer_t * cbuff );
 
+    /**
+     * [TREAD-SAFE] Gets the buffer's statistics
+     * @param cbuff Pointer to CircularBuffer_t object (NULL for the process wide ones only)
+     * @return Statistics
+     */
+    CircularBuffer_Stats_t (* stats)( CircularBuffer_t * cbuff );
+
     /**
      * Frees buffer content
      * @param cbuff Pointer to CircularBuffer_t object
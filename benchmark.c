@@ -0,0 +1,471 @@
+/**
+ * Benchmarks (usage: circular_buffer_benchmark [all|scaling|streaming|numa|copy|crc] [max threads])
+ */
+#define _GNU_SOURCE //CPU affinity
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+
+#include "CircularBuffer.h"
+
+//======= VARIABLES =======
+#define BENCH_BYTES       ( 256UL * 1024 * 1024 )
+#define BENCH_CHUNK       4096
+#define BENCH_BUFFER_SIZE ( 1024 * 1024 )
+#define BENCH_MAX_THREADS 8
+#define BENCH_STREAM_CHUNK  ( 64 * 1024 )
+#define BENCH_STREAM_BUFFER ( 32 * 1024 * 1024 )
+#define BENCH_COPY_BYTES    ( 1024UL * 1024 * 1024 )
+//=========================
+
+/**
+ * Get timestamp
+ * @return timestamp now (in microseconds)
+ */
+static u_int64_t getTime() {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (u_int64_t) ( ts.tv_sec * 1000000 + ts.tv_nsec / 1000 );
+}
+
+/**
+ * Gets a deadline relative to now
+ * @param us Microseconds from now
+ * @return Absolute CLOCK_MONOTONIC deadline
+ */
+static struct timespec getDeadline( long us ) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    ts.tv_nsec += ( us * 1000 );
+    ts.tv_sec  += ( ts.tv_nsec / 1000000000 );
+    ts.tv_nsec %= 1000000000;
+
+    return ts;
+}
+
+/**
+ * Converts a byte count over a duration to MiB/s
+ * @param bytes Byte count
+ * @param us    Duration in microseconds
+ * @return Throughput in MiB/s
+ */
+static double toMiBps( u_int64_t bytes, u_int64_t us ) {
+    return ( us ? ( (double) bytes / ( 1024.0 * 1024.0 ) ) / ( (double) us / 1000000.0 ) : 0.0 );
+}
+
+/**
+ * Opens a last-level cache read event counter on the calling thread
+ * @param result Event result (PERF_COUNT_HW_CACHE_RESULT_ACCESS or PERF_COUNT_HW_CACHE_RESULT_MISS)
+ * @return Counter file descriptor (-1 when unavailable)
+ */
+static int openCounter( u_int64_t result ) {
+    struct perf_event_attr attr;
+
+    memset( &attr, 0, sizeof( attr ) );
+    attr.size           = sizeof( attr );
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.config         = ( PERF_COUNT_HW_CACHE_LL | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( result << 16 ) );
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    return (int) syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+}
+
+/**
+ * Reads and closes a hardware event counter
+ * @param fd Counter file descriptor
+ * @return Event count (0 when unavailable)
+ */
+static u_int64_t closeCounter( int fd ) {
+    u_int64_t count = 0;
+
+    if( fd >= 0 ) {
+        if( read( fd, &count, sizeof( count ) ) != sizeof( count ) )
+            count = 0;
+
+        close( fd );
+    }
+
+    return count;
+}
+
+CircularBuffer_t cbuff;
+
+atomic_size_t consumed;
+atomic_size_t checksums; //keeps the consumer work from being optimised away
+
+/**
+ * Producer method that writes BENCH_BYTES in BENCH_CHUNK chunks
+ * @return NULL
+ */
+static void * launchProducer() {
+    u_int8_t chunk[BENCH_CHUNK];
+    size_t   count = 0;
+
+    memset( chunk, 0xAB, BENCH_CHUNK );
+
+    while( count < BENCH_BYTES ) {
+        count += CircularBuffer.writeChunk( &cbuff, chunk, BENCH_CHUNK );
+    }
+
+    return NULL;
+}
+
+/**
+ * Consumer method that reads chunks and runs a checksum on them (stand-in for real work) until BENCH_BYTES are consumed
+ * @return NULL
+ */
+static void * launchConsumer() {
+    u_int8_t  chunk[BENCH_CHUNK];
+    u_int64_t checksum = 0;
+
+    while( atomic_load_explicit( &consumed, memory_order_relaxed ) < BENCH_BYTES ) {
+        const struct timespec deadline = getDeadline( 1000 );
+        const size_t          n        = CircularBuffer.readChunkUntil( &cbuff, chunk, BENCH_CHUNK, &deadline );
+
+        for( size_t i = 0; i < n; ++i ) {
+            checksum = ( checksum * 31 ) + chunk[i];
+        }
+
+        atomic_fetch_add_explicit( &consumed, n, memory_order_relaxed );
+    }
+
+    atomic_fetch_add_explicit( &checksums, checksum, memory_order_relaxed );
+
+    return NULL;
+}
+
+u_int64_t producer_us;
+u_int64_t consumer_refs;
+u_int64_t consumer_misses;
+
+/**
+ * Producer method that writes BENCH_BYTES in BENCH_STREAM_CHUNK chunks and times itself
+ * @return NULL
+ */
+static void * launchStreamProducer() {
+    static u_int8_t chunk[BENCH_STREAM_CHUNK];
+    size_t          count = 0;
+
+    memset( chunk, 0xCD, BENCH_STREAM_CHUNK );
+
+    const u_int64_t start = getTime();
+
+    while( count < BENCH_BYTES ) {
+        count += CircularBuffer.writeChunk( &cbuff, chunk, BENCH_STREAM_CHUNK );
+    }
+
+    producer_us = ( getTime() - start );
+
+    return NULL;
+}
+
+/**
+ * Consumer method that checksums BENCH_BYTES in place and counts its last-level cache read accesses/misses
+ * @return NULL
+ */
+static void * launchStreamConsumer() {
+    const int refs     = openCounter( PERF_COUNT_HW_CACHE_RESULT_ACCESS );
+    const int misses   = openCounter( PERF_COUNT_HW_CACHE_RESULT_MISS );
+    u_int64_t checksum = 0;
+    size_t    count    = 0;
+
+    while( count < BENCH_BYTES ) {
+        size_t           n    = 0;
+        const u_int8_t * data = CircularBuffer.peekRead( &cbuff, &n );
+
+        for( size_t i = 0; i < n; ++i ) {
+            checksum = ( checksum * 31 ) + data[i];
+        }
+
+        count += CircularBuffer.consume( &cbuff, n );
+    }
+
+    consumer_refs   = closeCounter( refs );
+    consumer_misses = closeCounter( misses );
+    atomic_fetch_add_explicit( &checksums, checksum, memory_order_relaxed );
+
+    return NULL;
+}
+
+/**
+ * Benchmark: plain vs non-temporal (streaming) copies into the buffer (SPSC)
+ */
+static void benchStreaming() {
+    const size_t thresholds[] = { 0, BENCH_STREAM_CHUNK };
+
+    printf( "=== Streaming stores: SPSC, %lu MiB in %d KiB chunks, %d MiB buffer ===\n",
+            ( BENCH_BYTES >> 20 ), ( BENCH_STREAM_CHUNK >> 10 ), ( BENCH_STREAM_BUFFER >> 20 ) );
+    printf( "%-18s %16s %22s\n", "stream_threshold", "producer MiB/s", "consumer LLC miss %" );
+
+    for( size_t i = 0; i < ( sizeof( thresholds ) / sizeof( thresholds[0] ) ); ++i ) {
+        pthread_t producer;
+        pthread_t consumer;
+
+        cbuff = CircularBuffer.create();
+        cbuff.options.mode             = CIRCULARBUFFER_MODE_SPSC;
+        cbuff.options.blocking_write   = true;
+        cbuff.options.stream_threshold = thresholds[i];
+        cbuff.options.wait             = (CircularBuffer_WaitStrategy_t) { .spins = 100, .yields = 10, .park = CIRCULARBUFFER_PARK_FUTEX };
+        CircularBuffer.init( &cbuff, BENCH_STREAM_BUFFER );
+
+        pthread_create( &consumer, NULL, launchStreamConsumer, NULL );
+        pthread_create( &producer, NULL, launchStreamProducer, NULL );
+        pthread_join( producer, NULL );
+        pthread_join( consumer, NULL );
+
+        CircularBuffer.free( &cbuff );
+
+        if( consumer_refs > 0 ) {
+            printf( "%-18lu %16.1f %21.1f%%\n", thresholds[i], toMiBps( BENCH_BYTES, producer_us ), ( 100.0 * (double) consumer_misses / (double) consumer_refs ) );
+        } else {
+            printf( "%-18lu %16.1f %22s\n", thresholds[i], toMiBps( BENCH_BYTES, producer_us ), "n/a" );
+        }
+    }
+}
+
+/**
+ * Runs 1 producer against 1 consumer pinned to the first CPU, with the buffer's pages bound to the node of a CPU
+ * @param cpu  CPU whose node holds the buffer's pages
+ * @param node Pointer to variable to set to the node the pages were bound to
+ * @return Throughput in MiB/s
+ */
+static double runNumaPlacement( int cpu, int * node ) {
+    pthread_t      producer;
+    pthread_t      consumer;
+    pthread_attr_t attr;
+    cpu_set_t      cpus;
+
+    cbuff = CircularBuffer.create();
+    cbuff.options.mode           = CIRCULARBUFFER_MODE_SPSC;
+    cbuff.options.blocking_write = true;
+    cbuff.options.numa           = CIRCULARBUFFER_NUMA_BIND;
+    cbuff.options.numa_cpu       = cpu;
+    cbuff.options.wait           = (CircularBuffer_WaitStrategy_t) { .spins = 100, .yields = 10, .park = CIRCULARBUFFER_PARK_FUTEX };
+    CircularBuffer.init( &cbuff, BENCH_STREAM_BUFFER );
+    atomic_store( &consumed, 0 );
+    *node = CircularBuffer.stats( &cbuff ).numa_node;
+
+    CPU_ZERO( &cpus );
+    CPU_SET( 0, &cpus );
+    pthread_attr_init( &attr );
+    pthread_attr_setaffinity_np( &attr, sizeof( cpus ), &cpus );
+
+    u_int64_t start = getTime();
+
+    pthread_create( &consumer, &attr, launchConsumer, NULL );
+    pthread_create( &producer, NULL, launchProducer, NULL );
+    pthread_join( producer, NULL );
+    pthread_join( consumer, NULL );
+
+    u_int64_t end = getTime();
+
+    pthread_attr_destroy( &attr );
+    CircularBuffer.free( &cbuff );
+
+    return toMiBps( BENCH_BYTES, ( end - start ) );
+}
+
+/**
+ * Benchmark: buffer pages local vs remote to the consumer (pinned to CPU 0, remote = node of the last CPU)
+ */
+static void benchNuma() {
+    const int    cpus[]  = { 0, (int) sysconf( _SC_NPROCESSORS_ONLN ) - 1 };
+    const char * names[] = { "local", "remote" };
+    int          nodes[] = { -1, -1 };
+
+    printf( "=== NUMA placement: SPSC, %lu MiB in %d B chunks, %d MiB buffer, consumer on CPU 0 ===\n",
+            ( BENCH_BYTES >> 20 ), BENCH_CHUNK, ( BENCH_STREAM_BUFFER >> 20 ) );
+    printf( "%-10s %6s %6s %14s\n", "placement", "cpu", "node", "MiB/s" );
+
+    for( int i = 0; i < 2; ++i ) {
+        const double mibps = runNumaPlacement( cpus[i], &nodes[i] );
+
+        printf( "%-10s %6d %6d %14.1f\n", names[i], cpus[i], nodes[i], mibps );
+    }
+
+    if( nodes[0] == nodes[1] ) {
+        printf( "(single node host: both placements are local)\n" );
+    }
+}
+
+/**
+ * Runs 1 producer against N consumers
+ * @param mode      Concurrency mode
+ * @param consumers Number of consumer threads
+ * @return Throughput in MiB/s
+ */
+static double runConsumerScaling( CircularBuffer_Mode_e mode, int consumers ) {
+    pthread_t producer;
+    pthread_t threads[BENCH_MAX_THREADS];
+
+    cbuff = CircularBuffer.create();
+    cbuff.options.mode           = mode;
+    cbuff.options.blocking_write = true;
+    cbuff.options.wait           = (CircularBuffer_WaitStrategy_t) { .spins = 100, .yields = 10, .park = CIRCULARBUFFER_PARK_FUTEX };
+    CircularBuffer.init( &cbuff, BENCH_BUFFER_SIZE );
+    atomic_store( &consumed, 0 );
+
+    u_int64_t start = getTime();
+
+    pthread_create( &producer, NULL, launchProducer, NULL );
+
+    for( int i = 0; i < consumers; ++i ) {
+        pthread_create( &threads[i], NULL, launchConsumer, NULL );
+    }
+
+    pthread_join( producer, NULL );
+
+    for( int i = 0; i < consumers; ++i ) {
+        pthread_join( threads[i], NULL );
+    }
+
+    u_int64_t end = getTime();
+
+    CircularBuffer.free( &cbuff );
+
+    return toMiBps( BENCH_BYTES, ( end - start ) );
+}
+
+/**
+ * Benchmark: consumer throughput scaling (LOCKED vs MPMC)
+ * @param max_threads Max number of consumer threads
+ */
+static void benchConsumerScaling( int max_threads ) {
+    printf( "=== Consumer scaling: 1 producer, %lu MiB in %d B chunks ===\n", ( BENCH_BYTES >> 20 ), BENCH_CHUNK );
+    printf( "%-10s %14s %14s\n", "consumers", "LOCKED MiB/s", "MPMC MiB/s" );
+
+    for( int n = 1; n <= max_threads; ++n ) {
+        const double locked = runConsumerScaling( CIRCULARBUFFER_MODE_LOCKED, n );
+        const double mpmc   = runConsumerScaling( CIRCULARBUFFER_MODE_MPMC, n );
+
+        printf( "%-10d %14.1f %14.1f\n", n, locked, mpmc );
+    }
+}
+
+/**
+ * Moves BENCH_COPY_BYTES through a cache resident buffer from a single thread (write then read each chunk)
+ * @param kernel Copy kernel
+ * @param chunk  Chunk length in bytes
+ * @param crc    Flag to move the chunks with `writeChunkCrc(..)`/`readChunkCrc(..)` (copy + CRC32C kernel)
+ * @return Throughput in MiB/s (0 when the CPU lacks the kernel)
+ */
+static double runCopyKernel( CircularBuffer_Copy_e kernel, size_t chunk, bool crc ) {
+    static u_int8_t src[BENCH_BUFFER_SIZE / 4];
+    static u_int8_t dst[BENCH_BUFFER_SIZE / 4];
+
+    cbuff = CircularBuffer.create();
+    cbuff.options.mode        = CIRCULARBUFFER_MODE_SPSC;
+    cbuff.options.copy_kernel = kernel;
+    CircularBuffer.init( &cbuff, BENCH_BUFFER_SIZE );
+
+    if( cbuff.options.copy_kernel != kernel ) { //fell back to libc
+        CircularBuffer.free( &cbuff );
+        return 0.0; //EARLY RETURN
+    }
+
+    u_int32_t write_crc = 0;
+    u_int32_t read_crc  = 0;
+    u_int64_t start     = getTime();
+
+    for( u_int64_t moved = 0; moved < BENCH_COPY_BYTES; moved += chunk ) {
+        if( crc ) {
+            CircularBuffer.writeChunkCrc( &cbuff, src, chunk, &write_crc );
+            CircularBuffer.readChunkCrc( &cbuff, dst, chunk, &read_crc );
+        } else {
+            CircularBuffer.writeChunk( &cbuff, src, chunk );
+            CircularBuffer.readChunk( &cbuff, dst, chunk );
+        }
+    }
+
+    u_int64_t end = getTime();
+
+    if( write_crc != read_crc ) {
+        printf( "CRC mismatch: %08x written, %08x read\n", write_crc, read_crc );
+    }
+
+    CircularBuffer.free( &cbuff );
+
+    return toMiBps( BENCH_COPY_BYTES, ( end - start ) );
+}
+
+/**
+ * Benchmark: copy kernels against libc `memcpy` over chunk lengths
+ */
+static void benchCopyKernels() {
+    const size_t                chunks[]  = { 64, 256, 4096, 65536, ( BENCH_BUFFER_SIZE / 4 ) };
+    const CircularBuffer_Copy_e kernels[] = { CIRCULARBUFFER_COPY_LIBC, CIRCULARBUFFER_COPY_SSE2, CIRCULARBUFFER_COPY_AVX2, CIRCULARBUFFER_COPY_AVX512 };
+
+    printf( "=== Copy kernels: SPSC single thread, %lu MiB written and read in chunks, %d KiB buffer (MiB/s, 0: not supported) ===\n",
+            ( BENCH_COPY_BYTES >> 20 ), ( BENCH_BUFFER_SIZE >> 10 ) );
+    printf( "%-10s %12s %12s %12s %12s\n", "chunk", "libc", "sse2", "avx2", "avx512" );
+
+    for( size_t i = 0; i < ( sizeof( chunks ) / sizeof( chunks[0] ) ); ++i ) {
+        printf( "%-10lu", chunks[i] );
+
+        for( size_t k = 0; k < ( sizeof( kernels ) / sizeof( kernels[0] ) ); ++k ) {
+            printf( " %12.1f", runCopyKernel( kernels[k], chunks[i], false ) );
+        }
+
+        printf( "\n" );
+    }
+}
+
+/**
+ * Benchmark: fused copy + CRC32C against a plain libc `memcpy` over chunk lengths
+ */
+static void benchCopyCrc() {
+    const size_t chunks[] = { 64, 256, 4096, 65536, ( BENCH_BUFFER_SIZE / 4 ) };
+
+    printf( "=== Copy + CRC32C (%s): SPSC single thread, %lu MiB written and read in chunks, %d KiB buffer ===\n",
+            CircularBuffer.stats( NULL ).crc_kernel, ( BENCH_COPY_BYTES >> 20 ), ( BENCH_BUFFER_SIZE >> 10 ) );
+    printf( "%-10s %14s %14s\n", "chunk", "memcpy MiB/s", "+CRC MiB/s" );
+
+    for( size_t i = 0; i < ( sizeof( chunks ) / sizeof( chunks[0] ) ); ++i ) {
+        const double plain = runCopyKernel( CIRCULARBUFFER_COPY_LIBC, chunks[i], false );
+        const double crc   = runCopyKernel( CIRCULARBUFFER_COPY_LIBC, chunks[i], true );
+
+        printf( "%-10lu %14.1f %14.1f\n", chunks[i], plain, crc );
+    }
+}
+
+int main( int argc, char ** argv ) {
+    const char * bench       = ( argc > 1 ? argv[1] : "all" );
+    long         max_threads = ( argc > 2 ? atol( argv[2] ) : sysconf( _SC_NPROCESSORS_ONLN ) - 1 );
+
+    if( max_threads < 1 )
+        max_threads = 1;
+    if( max_threads > BENCH_MAX_THREADS )
+        max_threads = BENCH_MAX_THREADS;
+
+    printf( "Copy kernels up to: %s, CRC32C kernel: %s\n", CircularBuffer.stats( NULL ).copy_kernel, CircularBuffer.stats( NULL ).crc_kernel );
+
+    if( strcmp( bench, "all" ) == 0 || strcmp( bench, "scaling" ) == 0 ) {
+        benchConsumerScaling( (int) max_threads );
+    }
+
+    if( strcmp( bench, "all" ) == 0 || strcmp( bench, "streaming" ) == 0 ) {
+        benchStreaming();
+    }
+
+    if( strcmp( bench, "all" ) == 0 || strcmp( bench, "numa" ) == 0 ) {
+        benchNuma();
+    }
+
+    if( strcmp( bench, "all" ) == 0 || strcmp( bench, "copy" ) == 0 ) {
+        benchCopyKernels();
+    }
+
+    if( strcmp( bench, "all" ) == 0 || strcmp( bench, "crc" ) == 0 ) {
+        benchCopyCrc();
+    }
+
+    return 0;
+}
@@ -1,8 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <time.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 
 #include "CircularBuffer.h"
 
@@ -11,8 +16,67 @@
 #define WRITE_CHUNKS   1000
 #define READ_CHUNKS    1000
 #define CBUFFER_SIZE   5000
+#define POOL_THREADS      3
+#define RECORD_LENGTH  1000 //source offset (BYTES: end of stream) and length (2 x u_int32_t) then the payload
+#define RECORD_PAYLOAD ( RECORD_LENGTH - 2 * sizeof( u_int32_t ) )
+#define HUGE_PAGE_SIZE ( 2UL * 1024 * 1024 )
 //=========================
 
+/**
+ * Test kinds (the buffer APIs each one moves the data through)
+ */
+typedef enum {
+    TEST_CHUNK = 0, //writeChunk/readChunk
+    TEST_DEADLINE,  //writeChunkUntil/readChunkUntil, then both timing out on a full/empty buffer
+    TEST_PARTIAL,   //writeSome/tryReadChunk, then both on a full/empty buffer
+    TEST_WAKE,      //writeChunk/readChunkUntil with a wake threshold, then a parked consumer left asleep below it
+    TEST_MULTI,     //writeChunk/readChunk from pools of producers and consumers (records tagged with their source offset)
+    TEST_CRC,       //writeChunkCrc/readChunkCrc (CRCs of both sides compared too)
+    TEST_VECTORED,  //writeChunkV/readChunkV
+    TEST_RESERVE,   //reserveWrite/commitWrite and peekRead/consume
+    TEST_FD,        //writeFromFd|spliceFromPipe fed by a pipe, readToFd to a file
+    TEST_BROADCAST, //writeChunk and 2 readers with readChunkAs
+    TEST_URING,     //io_uring engine on the producer side, the consumer side or both
+    TEST_RESIZE,    //writeChunk/readChunk while the buffer is grown twice
+    TEST_TRIM,      //writeChunk/readChunk with trim() or the idle auto-trim, prefault buffers refusing both
+    TEST_HUGE,      //writeChunk/readChunk on 2 MiB huge pages (or the normal pages they fall back to), bad sizes refused
+    TEST_NUMA,      //writeChunk/readChunk with the pages bound to CPU 0's node (variant 0) or interleaved (variant 1)
+    TEST_LOCK,      //writeChunk/readChunk with the pages locked in memory, trim() refused
+    TEST_COUNT
+} Test_e;
+
+/**
+ * Test kind settings: rounds rotate through the modes first, then power_of_two, then the variants
+ */
+const struct {
+    const char          * name;
+    int                   rounds;
+    int                   mode_count;
+    CircularBuffer_Mode_e modes[4];
+
+} tests[TEST_COUNT] = {
+    [TEST_CHUNK]     = { "chunk",     100, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_DEADLINE]  = { "deadline",    8, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_PARTIAL]   = { "partial",     8, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_WAKE]      = { "wake",        8, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_MULTI]     = { "multi",      16, 2, { CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_CRC]       = { "crc",        16, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_VECTORED]  = { "vectored",    8, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_RESERVE]   = { "reserve",    16, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_FD]        = { "fd",         16, 2, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC } },
+    [TEST_BROADCAST] = { "broadcast",   4, 1, { CIRCULARBUFFER_MODE_BROADCAST } },
+    [TEST_URING]     = { "io_uring",   12, 1, { CIRCULARBUFFER_MODE_SPSC } },
+    [TEST_RESIZE]    = { "resize",     16, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_TRIM]      = { "trim",       32, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_HUGE]      = { "huge",        8, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_NUMA]      = { "numa",       16, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+    [TEST_LOCK]      = { "lock",        8, 4, { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC } },
+};
+
+Test_e      test    = TEST_CHUNK;
+int         variant = 0;
+atomic_bool failed  = false; //set by the test threads when one of their checks fails
+
 /**
  * Get timestamp
  * @return timestamp now
@@ -23,6 +87,19 @@ u_int64_t getTime() {
     return (u_int64_t) (ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
 }
 
+/**
+ * Get an absolute CLOCK_MONOTONIC deadline
+ * @param ms Time from now in ms
+ * @return deadline
+ */
+struct timespec deadlineIn( long ms ) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    ts.tv_sec  += ( ts.tv_nsec + ms * 1000000 ) / 1000000000;
+    ts.tv_nsec  = ( ts.tv_nsec + ms * 1000000 ) % 1000000000;
+    return ts;
+}
+
 CircularBuffer_t cbuff;
 
 struct {
@@ -43,6 +120,74 @@ struct {
     .buffer = {}
 };
 
+struct { //second broadcast reader
+    pthread_t thread;
+    u_int8_t  buffer[BYTES];
+
+} mirror = {
+    .thread = PTHREAD_CREATE_DETACHED,
+    .buffer = {}
+};
+
+struct { //consumer parked by `checkWakeThreshold()`
+    pthread_t thread;
+    size_t    read;
+    u_int64_t waited;
+
+} sleeper = {
+    .thread = PTHREAD_CREATE_DETACHED,
+    .read   = 0,
+    .waited = 0
+};
+
+struct { //producer blocked in `writeFromFd(..)`/`spliceFromPipe(..)` by `checkFdUnlocked()`/`checkFdPinned()`
+    pthread_t thread;
+    int       pipe[2];
+    bool      splice;
+    ssize_t   read;
+
+} ingest = {
+    .thread = PTHREAD_CREATE_DETACHED,
+    .pipe   = { -1, -1 },
+    .splice = false,
+    .read   = 0
+};
+
+struct { //consumer blocked in `readToFd(..)` by `checkDrainUnlocked()`/`checkDrainPinned()`
+    pthread_t thread;
+    int       pipe[2];
+    ssize_t   written;
+
+} drain = {
+    .thread  = PTHREAD_CREATE_DETACHED,
+    .pipe    = { -1, -1 },
+    .written = 0
+};
+
+struct { //producer and consumer pools
+    pthread_t producers[POOL_THREADS];
+    pthread_t consumers[POOL_THREADS];
+
+} pool;
+
+struct { //fd and io_uring plumbing
+    pthread_t              thread;
+    int                    in[2];
+    int                    out[2];
+    FILE                 * file;
+    CircularBuffer_Uring_t uring;
+    atomic_bool            produced;
+    u_int32_t              crc[2];
+
+} io = {
+    .thread   = PTHREAD_CREATE_DETACHED,
+    .in       = { -1, -1 },
+    .out      = { -1, -1 },
+    .file     = NULL,
+    .produced = false,
+    .crc      = { 0, 0 }
+};
+
 /**
  * Fills a buffer with random data
  * @param buff   Pointer to buffer array
@@ -110,19 +255,211 @@ size_t compareBuff( u_int8_t * buff_a, u_int8_t * buff_b, size_t length ) {
     return diff_count;
 }
 
+/**
+ * Feeder method that writes source data to the input pipe
+ * @return NULL
+ */
+static void * launchFeeder() {
+    size_t count = 0;
+    while( count < BYTES ) {
+        size_t  to_write = ( BYTES - count < WRITE_CHUNKS ? ( BYTES - count ) : WRITE_CHUNKS );
+        ssize_t ret      = write( io.in[1], &source.buffer[count], to_write );
+
+        if( ret < 0 )
+            break;
+
+        count += (size_t) ret;
+        usleep( rand() % 1000 );
+    }
+
+    close( io.in[1] );
+    io.in[1] = -1;
+
+    return NULL;
+}
+
+/**
+ * Pool producer method that sends every POOL_THREADS-th record of the source data to CircularBuffer
+ * @param arg Index in the pool
+ * @return NULL
+ */
+static void * launchPoolProducer( void * arg ) {
+    u_int8_t record[RECORD_LENGTH];
+
+    for( size_t offset = ( (size_t) arg * RECORD_PAYLOAD ); offset < BYTES; offset += ( POOL_THREADS * RECORD_PAYLOAD ) ) {
+        const u_int32_t header[2] = { (u_int32_t) offset, (u_int32_t) ( BYTES - offset < RECORD_PAYLOAD ? ( BYTES - offset ) : RECORD_PAYLOAD ) };
+
+        memcpy( record, header, sizeof( header ) );
+        memcpy( &record[sizeof( header )], &source.buffer[offset], header[1] );
+
+        if( CircularBuffer.writeChunk( &cbuff, record, RECORD_LENGTH ) != RECORD_LENGTH )
+            atomic_store( &failed, true );
+
+        usleep( rand() % 1000 );
+    }
+
+    return NULL;
+}
+
+/**
+ * Gets the number of threads in the consumer pool
+ * @return Consumer count (1 but in MPMC mode)
+ */
+static size_t poolConsumers() {
+    return ( cbuff.options.mode == CIRCULARBUFFER_MODE_MPMC ? POOL_THREADS : 1 );
+}
+
+/**
+ * Producer method that runs the producer pool then ends the stream of each pool consumer
+ * @return NULL
+ */
+static void * launchProducerPool() {
+    u_int8_t        record[RECORD_LENGTH] = { 0 };
+    const u_int32_t header[2]             = { BYTES, 0 };
+
+    for( size_t i = 0; i < POOL_THREADS; ++i ) {
+        pthread_create( &pool.producers[i], NULL, launchPoolProducer, (void *) i );
+    }
+
+    for( size_t i = 0; i < POOL_THREADS; ++i ) {
+        pthread_join( pool.producers[i], NULL );
+    }
+
+    memcpy( record, header, sizeof( header ) );
+
+    for( size_t i = 0; i < poolConsumers(); ++i ) {
+        CircularBuffer.writeChunk( &cbuff, record, RECORD_LENGTH );
+    }
+
+    return NULL;
+}
+
 /**
  * Producer method that sends source data to CircularBuffer
  * @return NULL
  */
 static void * launchProducer() {
     size_t count = 0;
+
+    if( test == TEST_URING && io.uring.source >= 0 ) //the engine ingests the input pipe
+        return launchFeeder(); //EARLY RETURN
+
+    if( test == TEST_MULTI ) //the pool shares out the source data
+        return launchProducerPool(); //EARLY RETURN
+
     while( count < BYTES ) {
         size_t to_write = ( BYTES - count < WRITE_CHUNKS ? ( BYTES - count ) : WRITE_CHUNKS );
 #ifndef NDEBUG
         printf( "writing %ldB... %ld->%ld\n", to_write, count, count + to_write );
 #endif
-        count += CircularBuffer.writeChunk( &cbuff, &source.buffer[count], to_write );
-        usleep( rand() % 1000 );
+        switch( test ) {
+            case TEST_DEADLINE: {
+                const struct timespec deadline = deadlineIn( 1000 );
+                count += CircularBuffer.writeChunkUntil( &cbuff, &source.buffer[count], to_write, &deadline );
+            } break;
+
+            case TEST_PARTIAL: //what does not fit goes with the next call
+                count += CircularBuffer.writeSome( &cbuff, &source.buffer[count], to_write );
+                break;
+
+            case TEST_CRC:
+                count += CircularBuffer.writeChunkCrc( &cbuff, &source.buffer[count], to_write, &io.crc[0] );
+                break;
+
+            case TEST_VECTORED: { //header, payload and trailer
+                const size_t       header = ( to_write < 16 ? to_write : 16 );
+                const size_t       footer = ( to_write - header < 8 ? ( to_write - header ) : 8 );
+                const struct iovec iov[3] = {
+                    { .iov_base = &source.buffer[count], .iov_len = header },
+                    { .iov_base = &source.buffer[count + header], .iov_len = ( to_write - header - footer ) },
+                    { .iov_base = &source.buffer[count + to_write - footer], .iov_len = footer },
+                };
+
+                count += CircularBuffer.writeChunkV( &cbuff, iov, 3 );
+            } break;
+
+            case TEST_RESERVE: { //odd variants only commit the start of the reservation (refused in MPSC/MPMC modes)
+                u_int8_t   * range  = CircularBuffer.reserveWrite( &cbuff, to_write );
+                const size_t commit = ( variant % 2 ? ( to_write / 2 + 1 ) : to_write );
+                const bool   shared = ( cbuff.options.mode == CIRCULARBUFFER_MODE_MPSC || cbuff.options.mode == CIRCULARBUFFER_MODE_MPMC );
+
+                if( range != NULL ) {
+                    memcpy( range, &source.buffer[count], commit );
+
+                    if( shared && commit < to_write ) { //left pending: completed and committed whole
+                        if( CircularBuffer.commitWrite( &cbuff, commit ) != 0 )
+                            atomic_store( &failed, true );
+
+                        memcpy( &range[commit], &source.buffer[count + commit], ( to_write - commit ) );
+                        count += CircularBuffer.commitWrite( &cbuff, to_write );
+
+                    } else {
+                        count += CircularBuffer.commitWrite( &cbuff, commit );
+                    }
+                }
+            } break;
+
+            case TEST_FD: { //input pipe spliced (odd variants) or read into the buffer
+                const ssize_t ret = ( variant % 2 ? CircularBuffer.spliceFromPipe( &cbuff, io.in[0], to_write )
+                                                  : CircularBuffer.writeFromFd( &cbuff, io.in[0], to_write ) );
+
+                if( ret > 0 ) {
+                    count += (size_t) ret;
+                } else if( ret == 0 || errno != ENOBUFS ) { //end-of-file or error
+                    return NULL; //EARLY RETURN
+                }
+            } continue; //paced by the feeder
+
+            default:
+                count += CircularBuffer.writeChunk( &cbuff, &source.buffer[count], to_write );
+                break;
+        }
+
+        usleep( rand() % ( test == TEST_TRIM ? 3000 : 1000 ) ); //leaves idle windows for the auto-trim
+    }
+
+    atomic_store( &io.produced, true );
+
+    return NULL;
+}
+
+/**
+ * Pool consumer method that puts the records read from CircularBuffer back at their source offset until the end of the stream
+ * @return NULL
+ */
+static void * launchPoolConsumer() {
+    u_int8_t  record[RECORD_LENGTH];
+    u_int32_t header[2] = { 0, 0 };
+
+    while( header[0] != BYTES ) {
+        if( CircularBuffer.readChunk( &cbuff, record, RECORD_LENGTH ) != RECORD_LENGTH ) { //records are published whole and in order
+            atomic_store( &failed, true );
+            continue;
+        }
+
+        memcpy( header, record, sizeof( header ) );
+
+        if( header[0] + header[1] > BYTES ) {
+            atomic_store( &failed, true );
+        } else if( header[0] < BYTES ) {
+            memcpy( &target.buffer[header[0]], &record[sizeof( header )], header[1] );
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Consumer method that runs the consumer pool
+ * @return NULL
+ */
+static void * launchConsumerPool() {
+    for( size_t i = 0; i < poolConsumers(); ++i ) {
+        pthread_create( &pool.consumers[i], NULL, launchPoolConsumer, NULL );
+    }
+
+    for( size_t i = 0; i < poolConsumers(); ++i ) {
+        pthread_join( pool.consumers[i], NULL );
     }
 
     return NULL;
@@ -133,85 +470,1078 @@ static void * launchProducer() {
  * @return NULL
  */
 static void * launchConsumer() {
-    size_t count = 0;
+    const bool piped = ( test == TEST_URING && io.uring.sink >= 0 ); //the engine sends the buffer to the output pipe
+    size_t     count = 0;
+
+    if( test == TEST_MULTI ) //the pool shares out the records
+        return launchConsumerPool(); //EARLY RETURN
     while( count < BYTES ) {
         size_t to_read = ( BYTES - count < READ_CHUNKS ? ( BYTES - count ) : READ_CHUNKS );
 #ifndef NDEBUG
         printf( "reading %ldB... %ld->%ld\n", to_read, count, count + to_read );
 #endif
-        count += CircularBuffer.readChunk( &cbuff, &target.buffer[count], to_read );
+        switch( test ) {
+            case TEST_DEADLINE: {
+                const struct timespec deadline = deadlineIn( 1000 );
+                count += CircularBuffer.readChunkUntil( &cbuff, &target.buffer[count], to_read, &deadline );
+            } break;
+
+            case TEST_WAKE: { //the bytes under the threshold are left to the deadline
+                const struct timespec deadline = deadlineIn( 20 );
+                count += CircularBuffer.readChunkUntil( &cbuff, &target.buffer[count], to_read, &deadline );
+            } break;
+
+            case TEST_PARTIAL:
+                count += CircularBuffer.tryReadChunk( &cbuff, &target.buffer[count], to_read );
+                break;
+
+            case TEST_CRC:
+                count += CircularBuffer.readChunkCrc( &cbuff, &target.buffer[count], to_read, &io.crc[1] );
+                break;
+
+            case TEST_VECTORED: {
+                const struct iovec iov[2] = {
+                    { .iov_base = &target.buffer[count], .iov_len = ( to_read / 3 ) },
+                    { .iov_base = &target.buffer[count + to_read / 3], .iov_len = ( to_read - to_read / 3 ) },
+                };
+
+                count += CircularBuffer.readChunkV( &cbuff, iov, 2 );
+            } break;
+
+            case TEST_RESERVE: {
+                size_t           length = 0;
+                const u_int8_t * range  = CircularBuffer.peekRead( &cbuff, &length );
+
+                if( range != NULL ) { //MPMC mode peeks are consumed whole (never past the stream's end: nothing else writes)
+                    const size_t limit = ( cbuff.options.mode == CIRCULARBUFFER_MODE_MPMC ? ( BYTES - count ) : to_read );
+
+                    length = ( length < limit ? length : limit );
+                    memcpy( &target.buffer[count], range, length );
+                    count += CircularBuffer.consume( &cbuff, length );
+                }
+            } break;
+
+            case TEST_FD: { //written out to the output file
+                const ssize_t ret = CircularBuffer.readToFd( &cbuff, fileno( io.file ), to_read );
+
+                if( ret < 0 )
+                    return NULL; //EARLY RETURN
+
+                count += (size_t) ret;
+            } break;
+
+            case TEST_BROADCAST:
+                count += CircularBuffer.readChunkAs( &cbuff, 0, &target.buffer[count], to_read );
+                break;
+
+            case TEST_URING: {
+                if( !piped ) {
+                    count += CircularBuffer.readChunk( &cbuff, &target.buffer[count], to_read );
+                    break;
+                }
+
+                const ssize_t ret = read( io.out[0], &target.buffer[count], to_read );
+
+                if( ret <= 0 )
+                    return NULL; //EARLY RETURN
+
+                count += (size_t) ret;
+            } continue; //paced by the engine
+
+            default:
+                count += CircularBuffer.readChunk( &cbuff, &target.buffer[count], to_read );
+                break;
+        }
+
         usleep( rand() % 1000 );
     }
 
+    if( test == TEST_FD )
+        pread( fileno( io.file ), target.buffer, BYTES, 0 );
+
     return NULL;
 }
 
 /**
- * Run a test
- * @param round Test number
+ * Consumer method of the second broadcast reader
+ * @return NULL
+ */
+static void * launchMirror() {
+    size_t count = 0;
+    while( count < BYTES ) {
+        size_t to_read = ( BYTES - count < READ_CHUNKS / 3 ? ( BYTES - count ) : READ_CHUNKS / 3 );
+        count += CircularBuffer.readChunkAs( &cbuff, 1, &mirror.buffer[count], to_read );
+        usleep( rand() % 1000 );
+    }
+
+    return NULL;
+}
+
+/**
+ * io_uring engine method that runs until the input is all sent out
+ * @return NULL
+ */
+static void * launchEngine() {
+    CircularBuffer_Uring_t * uring = &io.uring;
+
+    while( !( ( uring->source >= 0 ? uring->eof : atomic_load( &io.produced ) )
+            && ( uring->sink < 0 || ( CircularBuffer.empty( &cbuff ) && !uring->drain.active ) ) ) )
+    {
+        const int ret = CircularBuffer.uringRun( uring, true );
+
+        if( ret < 0 )
+            break;
+
+        if( ret == 0 ) //nothing in flight
+            usleep( 100 );
+    }
+
+    CircularBuffer.uringFree( uring );
+
+    if( io.out[1] >= 0 ) {
+        close( io.out[1] );
+        io.out[1] = -1;
+    }
+
+    return NULL;
+}
+
+/**
+ * Checks that the deadline variants give up on time: a read on the empty buffer, then a write on the full buffer
  * @return Success
  */
-static bool run( int round, u_int64_t * time ) {
-    int ret    = 0;
-    FILE * in  = fopen( "in.txt", "w" );
-    FILE * out = fopen( "out.txt", "w" );
+static bool checkDeadlines() {
+    u_int8_t      * scratch  = malloc( cbuff.size );
+    struct timespec deadline = deadlineIn( 20 );
+    u_int64_t       start    = getTime();
+    bool            success  = ( scratch != NULL );
 
-    fillWithRandom( source.buffer, BYTES );
+    success = ( success && CircularBuffer.readChunkUntil( &cbuff, scratch, 1, &deadline ) == 0 && ( getTime() - start ) >= 19000 );
+    success = ( success && CircularBuffer.writeChunk( &cbuff, source.buffer, cbuff.size ) == cbuff.size );
 
-//    printf( "\n=== IN ====\n" );
-//    for( size_t i = 0; i < BYTES; ++i ) {
-//        printf( "%d ", source.buffer[i] );
-//    }
+    deadline = deadlineIn( 20 );
+    start    = getTime();
+    success  = ( success && CircularBuffer.writeChunkUntil( &cbuff, source.buffer, 1, &deadline ) == 0 && ( getTime() - start ) >= 19000 );
+    success  = ( success && CircularBuffer.readChunk( &cbuff, scratch, cbuff.size ) == cbuff.size && checkEqual( source.buffer, scratch, cbuff.size ) );
 
-    cbuff = CircularBuffer.create();
-    CircularBuffer.init( &cbuff, CBUFFER_SIZE );
+    free( scratch );
+    return success;
+}
 
-    u_int64_t start = getTime();
+/**
+ * Checks that the non-blocking variants return at once: nothing read from the empty buffer, a write larger than the
+ * buffer cut down to its size, then nothing more written to the full buffer
+ * @return Success
+ */
+static bool checkPartial() {
+    u_int8_t * scratch = malloc( cbuff.size );
+    bool       success = ( scratch != NULL );
 
-    if( ( ret = pthread_create( &source.thread, NULL, launchProducer, NULL ) ) != 0 ) {
-        fprintf( stderr, "Failed to create producer thread (%d)\n", ret );
+    success = ( success && CircularBuffer.tryReadChunk( &cbuff, scratch, 1 ) == 0 );
+    success = ( success && CircularBuffer.writeSome( &cbuff, source.buffer, ( cbuff.size + 100 ) ) == cbuff.size );
+    success = ( success && CircularBuffer.writeSome( &cbuff, source.buffer, 1 ) == 0 );
+    success = ( success && CircularBuffer.tryReadChunk( &cbuff, scratch, ( cbuff.size + 100 ) ) == cbuff.size && checkEqual( source.buffer, scratch, cbuff.size ) );
+
+    free( scratch );
+    return success;
+}
+
+/**
+ * Checks that writes above and below the streaming threshold land intact: chunks from unaligned source offsets, the
+ * cursor first moved off the page start so that the larger ones straddle the wrap
+ * @return Success
+ */
+static bool checkStreamCopy() {
+    const size_t     lengths[] = { 1, 15, 17, 255, 256, 257, 1000, 3001 };
+    CircularBuffer_t other     = CircularBuffer.create();
+    u_int8_t       * scratch   = NULL;
+    size_t           offset    = 1;
+    bool             success;
+
+    other.options.mode             = cbuff.options.mode;
+    other.options.stream_threshold = 256;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || ( scratch = malloc( other.size + 1 ) ) == NULL ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
     }
 
-    if( ( ret = pthread_create( &target.thread, NULL, launchConsumer, NULL ) ) != 0 ) {
-        fprintf( stderr, "Failed to create consumer thread (%d)\n", ret );
+    success = ( CircularBuffer.writeChunk( &other, source.buffer, ( other.size - 700 ) ) == ( other.size - 700 ) );
+    success = ( CircularBuffer.readChunk( &other, scratch, ( other.size - 700 ) ) == ( other.size - 700 ) && success );
+
+    for( size_t pass = 0; pass < 3; ++pass ) {
+        for( size_t i = 0; i < ( sizeof( lengths ) / sizeof( lengths[0] ) ); ++i ) {
+            success = ( CircularBuffer.writeChunk( &other, &source.buffer[offset], lengths[i] ) == lengths[i] && success );
+            success = ( CircularBuffer.readChunk( &other, &scratch[1], lengths[i] ) == lengths[i] && success );
+            success = ( checkEqual( &source.buffer[offset], &scratch[1], lengths[i] ) && success );
+            offset += ( lengths[i] + 3 );
+        }
     }
 
-    pthread_join( target.thread, NULL );
-    pthread_join( source.thread, NULL );
+    free( scratch );
+    CircularBuffer.free( &other );
 
-    u_int64_t end = getTime();
+    return success;
+}
 
-    printBuffToFile( in, source.buffer, BYTES );
-    printBuffToFile( out, target.buffer, BYTES );
+/**
+ * Producer method that reserves a range right after the main thread's and commits it (waiting for the main thread's commit)
+ * @param arg Pointer to CircularBuffer_t object
+ * @return NULL
+ */
+static void * launchSecondProducer( void * arg ) {
+    u_int8_t * range = CircularBuffer.reserveWrite( arg, 100 );
 
-//    printf( "\n=== OUT ====\n" );
-//    size_t diff = compareBuff( source.buffer, target.buffer, BYTES );
-//    printf( "\n===========\n" );
+    if( range != NULL )
+        memcpy( range, &source.buffer[100], 100 );
 
-    fclose( in );
-    fclose( out );
+    atomic_store( &io.produced, true );
 
-    if( time )
-        *time = ( end - start );
+    if( range == NULL || CircularBuffer.commitWrite( arg, 100 ) != 100 )
+        atomic_store( &failed, true );
 
-    return checkEqual( source.buffer, target.buffer, BYTES );
+    return NULL;
 }
 
-int main() {
-    const int test_count  = 100;
-    int       test_number = 0;
-    u_int64_t timers[test_count];
-    u_int64_t checks[test_count];
+/**
+ * Checks that MPSC/MPMC mode reservations overtaken by another producer's claim are only committed whole: the
+ * unwritten end of the first reservation never gets published ahead of the second one
+ * @return Success
+ */
+static bool checkSharedCommit() {
+    const CircularBuffer_Mode_e modes[2] = { CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC };
+    u_int8_t                    scratch[200];
+    bool                        success  = true;
+
+    for( int i = 0; i < 2; ++i ) {
+        CircularBuffer_t other = CircularBuffer.create();
+        pthread_t        second;
+        u_int8_t       * range   = NULL;
+
+        other.options.mode = modes[i];
+        atomic_store( &io.produced, false );
+
+        if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || ( range = CircularBuffer.reserveWrite( &other, 100 ) ) == NULL ) {
+            CircularBuffer.free( &other );
+            return false; //EARLY RETURN
+        }
+
+        pthread_create( &second, NULL, launchSecondProducer, &other );
+
+        while( !atomic_load( &io.produced ) ) { //second range claimed
+            usleep( 100 );
+        }
+
+        memcpy( range, source.buffer, 50 );
+        success = ( CircularBuffer.commitWrite( &other, 50 ) == 0 && success );
+        memcpy( &range[50], &source.buffer[50], 50 );
+        success = ( CircularBuffer.commitWrite( &other, 100 ) == 100 && success );
+        pthread_join( second, NULL );
+
+        success = ( CircularBuffer.tryReadChunk( &other, scratch, 200 ) == 200 && checkEqual( source.buffer, scratch, 200 ) && success );
+        CircularBuffer.free( &other );
+    }
+
+    return success;
+}
+
+/**
+ * Consumer method that peeks at a range right after the main thread's and consumes it (waiting for the main thread's consume)
+ * @param arg Pointer to CircularBuffer_t object
+ * @return NULL
+ */
+static void * launchSecondConsumer( void * arg ) {
+    size_t           length = 0;
+    const u_int8_t * range  = CircularBuffer.peekRead( arg, &length );
+
+    atomic_store( &io.produced, true );
+
+    if( range == NULL || length != 100 || !checkEqual( &source.buffer[100], range, 100 ) || CircularBuffer.consume( arg, 100 ) != 100 )
+        atomic_store( &failed, true );
+
+    return NULL;
+}
+
+/**
+ * Checks that MPMC mode peeks overtaken by another consumer's claim are only consumed whole: the unread end
+ * of the first peek never gets released ahead of the second one
+ * @return Success
+ */
+static bool checkSharedConsume() {
+    CircularBuffer_t other   = CircularBuffer.create();
+    pthread_t        second;
+    size_t           length  = 0;
+    const u_int8_t * range   = NULL;
+    u_int8_t         scratch[1];
+    bool             success = true;
+
+    other.options.mode = CIRCULARBUFFER_MODE_MPMC;
+    atomic_store( &io.produced, false );
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE )
+        || CircularBuffer.writeChunk( &other, source.buffer, 100 ) != 100
+        || ( range = CircularBuffer.peekRead( &other, &length ) ) == NULL )
+    {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    success = ( length == 100 && CircularBuffer.writeChunk( &other, &source.buffer[100], 100 ) == 100 );
+
+    pthread_create( &second, NULL, launchSecondConsumer, &other );
+
+    while( !atomic_load( &io.produced ) ) { //second range claimed
+        usleep( 100 );
+    }
+
+    success = ( checkEqual( source.buffer, range, 100 ) && success );
+    success = ( CircularBuffer.consume( &other, 50 ) == 0 && success );
+    success = ( CircularBuffer.consume( &other, 100 ) == 100 && success );
+    pthread_join( second, NULL );
+
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 1 ) == 0 && success );
+    CircularBuffer.free( &other );
 
-    while( test_number < test_count ) {
-        checks[test_number] = run( test_number, &timers[test_number] );
-        ++test_number;
-    };
+    return success;
+}
+
+/**
+ * Producer method that reads/splices from the empty `ingest.pipe` into the buffer (blocks until the pipe is written to)
+ * @param arg Pointer to CircularBuffer_t object
+ * @return NULL
+ */
+static void * launchIngest( void * arg ) {
+    ingest.read = ( ingest.splice ? CircularBuffer.spliceFromPipe( arg, ingest.pipe[0], 100 )
+                                  : CircularBuffer.writeFromFd( arg, ingest.pipe[0], 100 ) );
+    return NULL;
+}
+
+/**
+ * Checks that a LOCKED mode `writeFromFd(..)`/`spliceFromPipe(..)` blocked in its syscall leaves the mutex free:
+ * consumers and other producers go on (the latter without getting the range being filled)
+ * @param splice Flag to check `spliceFromPipe(..)` instead of `writeFromFd(..)`
+ * @return Success
+ */
+static bool checkFdUnlocked( bool splice ) {
+    CircularBuffer_t other   = CircularBuffer.create();
+    u_int8_t         scratch[100];
+    bool             success = true;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || pipe( ingest.pipe ) != 0 ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    ingest.splice = splice;
+    pthread_create( &ingest.thread, NULL, launchIngest, &other );
+
+    while( atomic_load( &other.position.write_claim ) <= atomic_load( &other.position.write ) ) { //range claimed
+        usleep( 100 );
+    }
+
+    success = ( pthread_mutex_trylock( &other.mutex ) == 0 && pthread_mutex_unlock( &other.mutex ) == 0 );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 100 ) == 0 && success );
+    success = ( CircularBuffer.writeSome( &other, source.buffer, 100 ) == 0 && success ); //range being read into
+
+    write( ingest.pipe[1], source.buffer, 50 );
+    pthread_join( ingest.thread, NULL );
+    close( ingest.pipe[0] );
+    close( ingest.pipe[1] );
+
+    success = ( ingest.read == 50 && success );
+    success = ( CircularBuffer.writeSome( &other, &source.buffer[50], 50 ) == 50 && success );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 100 ) == 100 && checkEqual( source.buffer, scratch, 100 ) && success );
+    CircularBuffer.free( &other );
+
+    return success;
+}
+
+/**
+ * Consumer method that writes the buffer out to the full `drain.pipe` (blocks until the pipe is read from)
+ * @param arg Pointer to CircularBuffer_t object
+ * @return NULL
+ */
+static void * launchDrain( void * arg ) {
+    drain.written = CircularBuffer.readToFd( arg, drain.pipe[1], 100 );
+    return NULL;
+}
+
+/**
+ * Checks that a LOCKED mode `readToFd(..)` blocked in write(2) leaves the mutex free: producers and other
+ * consumers go on (the latter without getting the range being written out)
+ * @return Success
+ */
+static bool checkDrainUnlocked() {
+    CircularBuffer_t other   = CircularBuffer.create();
+    u_int8_t         scratch[4096];
+    size_t           filled  = 0;
+    ssize_t          ret     = 0;
+    bool             success = true;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || pipe( drain.pipe ) != 0 ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    fcntl( drain.pipe[1], F_SETFL, O_NONBLOCK );
+
+    while( ( ret = write( drain.pipe[1], scratch, sizeof( scratch ) ) ) > 0 ) { //pipe filled up
+        filled += (size_t) ret;
+    }
+
+    fcntl( drain.pipe[1], F_SETFL, 0 );
+
+    success = ( CircularBuffer.writeChunk( &other, source.buffer, 100 ) == 100 );
+    pthread_create( &drain.thread, NULL, launchDrain, &other );
+
+    while( atomic_load( &other.position.read_claim ) <= atomic_load( &other.position.read ) ) { //range claimed
+        usleep( 100 );
+    }
+
+    success = ( pthread_mutex_trylock( &other.mutex ) == 0 && pthread_mutex_unlock( &other.mutex ) == 0 && success );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 100 ) == 0 && success ); //range being written out
+    success = ( CircularBuffer.writeSome( &other, &source.buffer[100], 100 ) == 100 && success );
+
+    while( filled > 0 && ( ret = read( drain.pipe[0], scratch, ( filled < sizeof( scratch ) ? filled : sizeof( scratch ) ) ) ) > 0 ) {
+        filled -= (size_t) ret;
+    }
+
+    pthread_join( drain.thread, NULL );
+
+    success = ( drain.written == 100 && read( drain.pipe[0], scratch, 100 ) == 100 && checkEqual( source.buffer, scratch, 100 ) && success );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 100 ) == 100 && checkEqual( &source.buffer[100], scratch, 100 ) && success );
+
+    close( drain.pipe[0] );
+    close( drain.pipe[1] );
+    CircularBuffer.free( &other );
+
+    return success;
+}
+
+/**
+ * Checks that a producer blocked in `writeFromFd(..)`/`spliceFromPipe(..)` on a resizable lock-free buffer only pins
+ * the mapping: resize/trim return (refused) while it waits, the consumer gets through, then resize goes through once
+ * it returns
+ * @param splice Test `spliceFromPipe(..)` instead of `writeFromFd(..)`
+ * @return Success
+ */
+static bool checkFdPinned( bool splice ) {
+    CircularBuffer_t other   = CircularBuffer.create();
+    u_int8_t         scratch[50];
+    bool             success = true;
+
+    other.options.mode      = CIRCULARBUFFER_MODE_SPSC;
+    other.options.resizable = true;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || pipe( ingest.pipe ) != 0 ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    ingest.splice = splice;
+    pthread_create( &ingest.thread, NULL, launchIngest, &other );
+
+    while( atomic_load( &other.gate.pinned ) == 0 ) { //read(2)/splice(2) under way
+        usleep( 100 );
+    }
+
+    success = ( !CircularBuffer.resize( &other, ( 2 * CBUFFER_SIZE ) ) && !CircularBuffer.trim( &other ) );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 50 ) == 0 && success );
+
+    write( ingest.pipe[1], source.buffer, 50 );
+    pthread_join( ingest.thread, NULL );
+    close( ingest.pipe[0] );
+    close( ingest.pipe[1] );
+
+    success = ( ingest.read == 50 && CircularBuffer.resize( &other, ( 2 * CBUFFER_SIZE ) ) && success );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 50 ) == 50 && checkEqual( source.buffer, scratch, 50 ) && success );
+    CircularBuffer.free( &other );
+
+    return success;
+}
+
+/**
+ * Checks that a consumer blocked in `readToFd(..)` on a resizable lock-free buffer only pins the mapping: resize
+ * returns (refused) while it waits on the full pipe, the producer gets through, then resize goes through once it returns
+ * @return Success
+ */
+static bool checkDrainPinned() {
+    CircularBuffer_t other   = CircularBuffer.create();
+    u_int8_t         scratch[4096];
+    size_t           filled  = 0;
+    ssize_t          ret     = 0;
+    bool             success = true;
+
+    other.options.mode      = CIRCULARBUFFER_MODE_SPSC;
+    other.options.resizable = true;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || pipe( drain.pipe ) != 0 ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    fcntl( drain.pipe[1], F_SETFL, O_NONBLOCK );
+
+    while( ( ret = write( drain.pipe[1], scratch, sizeof( scratch ) ) ) > 0 ) { //pipe filled up
+        filled += (size_t) ret;
+    }
+
+    fcntl( drain.pipe[1], F_SETFL, 0 );
+
+    success = ( CircularBuffer.writeChunk( &other, source.buffer, 100 ) == 100 );
+    pthread_create( &drain.thread, NULL, launchDrain, &other );
+
+    while( atomic_load( &other.gate.pinned ) == 0 ) { //write(2) under way
+        usleep( 100 );
+    }
+
+    success = ( !CircularBuffer.resize( &other, ( 2 * CBUFFER_SIZE ) ) && success );
+    success = ( CircularBuffer.writeSome( &other, &source.buffer[100], 100 ) == 100 && success );
+
+    while( filled > 0 && ( ret = read( drain.pipe[0], scratch, ( filled < sizeof( scratch ) ? filled : sizeof( scratch ) ) ) ) > 0 ) {
+        filled -= (size_t) ret;
+    }
+
+    pthread_join( drain.thread, NULL );
+
+    success = ( drain.written == 100 && read( drain.pipe[0], scratch, 100 ) == 100 && checkEqual( source.buffer, scratch, 100 ) && success );
+    success = ( CircularBuffer.resize( &other, ( 2 * CBUFFER_SIZE ) ) && success );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 100 ) == 100 && checkEqual( &source.buffer[100], scratch, 100 ) && success );
+
+    close( drain.pipe[0] );
+    close( drain.pipe[1] );
+    CircularBuffer.free( &other );
+
+    return success;
+}
+
+/**
+ * Computes the CRC32C of a buffer bit by bit (reference for the buffer's copy + CRC32C kernels)
+ * @param buff   Pointer to buffer array
+ * @param length Length of the buffer
+ * @return CRC32C
+ */
+static u_int32_t crc32c( const u_int8_t * buff, size_t length ) {
+    u_int32_t crc = 0xFFFFFFFF;
+
+    for( size_t i = 0; i < length; ++i ) {
+        crc ^= buff[i];
+
+        for( int bit = 0; bit < 8; ++bit ) {
+            crc = ( ( crc & 1 ) ? ( ( crc >> 1 ) ^ 0x82F63B78 ) : ( crc >> 1 ) );
+        }
+    }
+
+    return ~crc;
+}
+
+/**
+ * Checks the write/read CRC32Cs against the known answer for "123456789" (whole and split over 2 writes) and against
+ * the reference for lengths around the 3-lane kernel's block boundaries (3 x 256 and 3 x 2048 bytes)
+ * @return Success
+ */
+static bool checkCrcVectors() {
+    const u_int8_t * check     = (const u_int8_t *) "123456789";
+    const size_t     lengths[] = { 1, 7, 8, 9, 767, 768, 769, 775, 1535, 1536, 1537, 6143, 6144, 6145, 6911, 6912, 6913, 6919, 7680 };
+    CircularBuffer_t other     = CircularBuffer.create();
+    u_int8_t       * scratch   = NULL;
+    u_int32_t        crc[2]    = { 0, 0 };
+    bool             success;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || ( scratch = malloc( other.size ) ) == NULL ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    success = ( CircularBuffer.writeChunkCrc( &other, check, 9, &crc[0] ) == 9 && crc[0] == 0xE3069283 );
+    success = ( CircularBuffer.readChunkCrc( &other, scratch, 9, &crc[1] ) == 9 && crc[1] == 0xE3069283 && success );
+
+    crc[0] = 0;
+    success = ( CircularBuffer.writeChunkCrc( &other, check, 4, &crc[0] ) == 4 && success );
+    success = ( CircularBuffer.writeChunkCrc( &other, &check[4], 5, &crc[0] ) == 5 && crc[0] == 0xE3069283 && success );
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 9 ) == 9 && success );
+
+    for( size_t i = 0; i < ( sizeof( lengths ) / sizeof( lengths[0] ) ) && lengths[i] <= other.size; ++i ) {
+        const u_int8_t * src = &source.buffer[i]; //unaligned starts too
+        const u_int32_t  ref = crc32c( src, lengths[i] );
+
+        crc[0] = 0;
+        crc[1] = 0;
+        success = ( CircularBuffer.writeChunkCrc( &other, src, lengths[i], &crc[0] ) == lengths[i] && crc[0] == ref && success );
+        success = ( CircularBuffer.readChunkCrc( &other, scratch, lengths[i], &crc[1] ) == lengths[i] && crc[1] == ref && success );
+        success = ( checkEqual( src, scratch, lengths[i] ) && success );
+    }
+
+    free( scratch );
+    CircularBuffer.free( &other );
+
+    return success;
+}
+
+/**
+ * Checks a huge page buffer's geometry against the pages it got (huge ones or the normal ones they fell back to),
+ * then that huge page sizes which are not a power of 2 above the page size fail `init(..)`
+ * @param stats Statistics of the huge page buffer
+ * @return Success
+ */
+static bool checkHugePages( CircularBuffer_Stats_t stats ) {
+    const size_t bad[2]  = { ( 3 * HUGE_PAGE_SIZE ), (size_t) getpagesize() };
+    bool         success = ( stats.page_size == ( stats.huge_page_fallback ? (size_t) getpagesize() : HUGE_PAGE_SIZE ) );
+
+    success = ( stats.size >= CBUFFER_SIZE && stats.size % stats.page_size == 0 && success );
+
+    for( int i = 0; i < 2; ++i ) {
+        CircularBuffer_t other = CircularBuffer.create();
+
+        other.options.huge_page_size = bad[i];
+        success = ( !CircularBuffer.init( &other, CBUFFER_SIZE ) && success );
+        CircularBuffer.free( &other );
+    }
+
+    return success;
+}
+
+/**
+ * Checks the NUMA policy the kernel holds for both sections of the buffer, and for BIND that the pages the round
+ * touched sit on the node reported by `stats(..)`
+ * @param policy Policy asked for (BIND or INTERLEAVE)
+ * @return Success
+ */
+static bool checkNuma( CircularBuffer_Numa_e policy ) {
+    const CircularBuffer_Stats_t stats   = CircularBuffer.stats( &cbuff );
+    const int                    mode    = ( policy == CIRCULARBUFFER_NUMA_BIND ? MPOL_BIND : MPOL_INTERLEAVE );
+    bool                         success = ( policy == CIRCULARBUFFER_NUMA_BIND ? stats.numa_node >= 0 : stats.numa_node == -1 );
+
+    for( size_t section = 0; section < 2; ++section ) {
+        u_int8_t * page = &cbuff.buffer[section * stats.size];
+        int        held = -1;
+        int        node = -1;
+
+        if( syscall( __NR_get_mempolicy, &held, NULL, 0UL, page, (unsigned long) MPOL_F_ADDR ) != 0 )
+            return ( errno == ENOSYS && stats.numa_node == -1 ); //EARLY RETURN (kernel without NUMA: nothing placed)
+
+        success = ( held == mode && success );
+
+        if( policy == CIRCULARBUFFER_NUMA_BIND ) {
+            success = ( syscall( __NR_get_mempolicy, &node, NULL, 0UL, page, (unsigned long) ( MPOL_F_NODE | MPOL_F_ADDR ) ) == 0
+                     && node == stats.numa_node && success );
+        }
+    }
+
+    return success;
+}
+
+/**
+ * Gets the memory the process has locked (`VmLck` of /proc/self/status)
+ * @return Locked bytes (0 when unknown)
+ */
+static size_t lockedBytes() {
+    FILE * status = fopen( "/proc/self/status", "r" );
+    char   line[128];
+    size_t locked = 0;
+
+    if( status == NULL )
+        return 0; //EARLY RETURN
+
+    while( fgets( line, sizeof( line ), status ) != NULL ) {
+        if( sscanf( line, "VmLck: %zu kB", &locked ) == 1 ) {
+            locked *= 1024;
+            break;
+        }
+    }
+
+    fclose( status );
+    return locked;
+}
+
+/**
+ * Checks that a `lock_pages` buffer has both sections of its mapping locked, all of its raw buffer resident
+ * and that `trim(..)` is refused
+ * @param locked Pointer to variable to set to the locked bytes expected once the buffer is freed
+ * @return Success
+ */
+static bool checkLockedPages( size_t * locked ) {
+    const CircularBuffer_Stats_t stats = CircularBuffer.stats( &cbuff );
+    const size_t                 bytes = lockedBytes();
+
+    *locked = ( bytes >= ( 2 * stats.size ) ? ( bytes - 2 * stats.size ) : 0 );
+
+    return ( bytes >= ( 2 * stats.size ) && stats.resident == stats.size && !CircularBuffer.trim( &cbuff ) );
+}
+
+/**
+ * Checks that an io_uring read left unsubmitted by a failed enter goes in with the next run, then that tearing the
+ * engine down with a read pending on an idle pipe cancels it (and publishes nothing)
+ * @return Success
+ */
+static bool checkUringTeardown() {
+    CircularBuffer_t       other   = CircularBuffer.create();
+    CircularBuffer_Uring_t engine  = { .source = -1, .sink = -1 };
+    int                    idle[2] = { -1, -1 };
+    u_int8_t               scratch[10];
+    bool                   success = true;
+
+    other.options.mode = CIRCULARBUFFER_MODE_SPSC;
+
+    if( !CircularBuffer.init( &other, CBUFFER_SIZE ) || pipe( idle ) != 0 || !CircularBuffer.uringInit( &engine, &other, idle[0], -1, 1000 ) ) {
+        CircularBuffer.free( &other );
+        return false; //EARLY RETURN
+    }
+
+    const int fd = engine.fd;
+
+    engine.fd = -1; //enter fails with the read queued
+    success   = ( CircularBuffer.uringRun( &engine, false ) < 0 && engine.ingest.active );
+    engine.fd = fd;
+
+    write( idle[1], source.buffer, 10 );
+
+    while( engine.ingest.active && CircularBuffer.uringRun( &engine, true ) >= 0 );
+
+    success = ( CircularBuffer.tryReadChunk( &other, scratch, 10 ) == 10 && checkEqual( source.buffer, scratch, 10 ) && success );
+    success = ( CircularBuffer.uringRun( &engine, false ) >= 0 && engine.ingest.active && success ); //read pending on the idle pipe
+
+    CircularBuffer.uringFree( &engine );
+
+    success = ( CircularBuffer.empty( &other ) && CircularBuffer.writeChunk( &other, source.buffer, 10 ) == 10 && success );
+
+    close( idle[0] );
+    close( idle[1] );
+    CircularBuffer.free( &other );
+
+    return success;
+}
+
+/**
+ * Consumer method that parks on the empty buffer for up to 200ms
+ * @return NULL
+ */
+static void * launchSleeper() {
+    const struct timespec deadline = deadlineIn( 200 );
+    const u_int64_t       start    = getTime();
+
+    sleeper.read   = CircularBuffer.readChunkUntil( &cbuff, mirror.buffer, BYTES, &deadline );
+    sleeper.waited = ( getTime() - start );
+
+    return NULL;
+}
+
+/**
+ * Checks that a parked consumer sleeps through a write under the wake threshold but not through one reaching it
+ * @return Success
+ */
+static bool checkWakeThreshold() {
+    bool success = true;
+
+    for( int i = 0; i < 2; ++i ) {
+        const size_t length = ( i == 0 ? 100 : cbuff.options.wake_threshold );
+
+        pthread_create( &sleeper.thread, NULL, launchSleeper, NULL );
+        usleep( 20000 );
+        CircularBuffer.writeChunk( &cbuff, source.buffer, length );
+        pthread_join( sleeper.thread, NULL );
+
+        success = ( success && sleeper.read == length && ( i == 0 ? ( sleeper.waited >= 199000 ) : ( sleeper.waited < 150000 ) ) );
+    }
+
+    return success;
+}
+
+/**
+ * Checks that unregistering readers is left to BROADCAST mode: the data of the other modes stays readable
+ * @return Success
+ */
+static bool checkRemoveReader() {
+    const CircularBuffer_Mode_e modes[4] = { CIRCULARBUFFER_MODE_LOCKED, CIRCULARBUFFER_MODE_SPSC, CIRCULARBUFFER_MODE_MPSC, CIRCULARBUFFER_MODE_MPMC };
+    u_int8_t                    scratch[100];
+    bool                        success  = true;
+
+    for( int i = 0; i < 4; ++i ) {
+        CircularBuffer_t other = CircularBuffer.create();
+
+        other.options.mode = modes[i];
+        success = ( CircularBuffer.init( &other, CBUFFER_SIZE ) && success );
+        success = ( CircularBuffer.writeChunk( &other, source.buffer, 100 ) == 100 && success );
+        CircularBuffer.removeReader( &other, 0 );
+        success = ( CircularBuffer.tryReadChunk( &other, scratch, 100 ) == 100 && checkEqual( source.buffer, scratch, 100 ) && success );
+        CircularBuffer.free( &other );
+    }
+
+    return success;
+}
+
+/**
+ * Sets up the pipes, file and engine of a test
+ * @return Success
+ */
+static bool openIo() {
+    if( test == TEST_FD ) {
+        return ( pipe( io.in ) == 0 && ( io.file = tmpfile() ) != NULL ); //EARLY RETURN
+    }
+
+    if( test == TEST_URING ) { //variant 0: both sides, 1: producer side only, 2: consumer side only
+        const bool source = ( variant % 3 != 2 );
+        const bool sink   = ( variant % 3 != 1 );
+
+        if( ( source && pipe( io.in ) != 0 ) || ( sink && pipe( io.out ) != 0 ) )
+            return false; //EARLY RETURN
+
+        if( !CircularBuffer.uringInit( &io.uring, &cbuff, ( source ? io.in[0] : -1 ), ( sink ? io.out[1] : -1 ), 3000 ) ) {
+            io.uring = (CircularBuffer_Uring_t) { .source = -1, .sink = -1 };
+            return false; //EARLY RETURN
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Tears down the pipes and file of a test
+ */
+static void closeIo() {
+    for( int i = 0; i < 2; ++i ) {
+        if( io.in[i] >= 0 )
+            close( io.in[i] );
+        if( io.out[i] >= 0 )
+            close( io.out[i] );
+
+        io.in[i]  = -1;
+        io.out[i] = -1;
+    }
+
+    if( io.file ) {
+        fclose( io.file );
+        io.file = NULL;
+    }
+}
+
+/**
+ * Run a test
+ * @param kind  Test kind
+ * @param round Round number within the kind
+ * @param time  Pointer to variable to set to the duration of the transfer
+ * @return Success
+ */
+static bool run( Test_e kind, int round, u_int64_t * time ) {
+    int    ret     = 0;
+    bool   success = true;
+    bool   helper  = false;
+    size_t locked  = 0;
+    FILE * in      = fopen( "in.txt", "w" );
+    FILE * out     = fopen( "out.txt", "w" );
+
+    fillWithRandom( source.buffer, BYTES );
+    memset( target.buffer, 0, BYTES );
+    memset( mirror.buffer, 0, BYTES );
+
+//    printf( "\n=== IN ====\n" );
+//    for( size_t i = 0; i < BYTES; ++i ) {
+//        printf( "%d ", source.buffer[i] );
+//    }
+
+    test    = kind;
+    variant = round / ( 2 * tests[kind].mode_count );
+    io.crc[0] = 0;
+    io.crc[1] = 0;
+    io.uring  = (CircularBuffer_Uring_t) { .source = -1, .sink = -1 };
+    atomic_store( &io.produced, false );
+    atomic_store( &failed, false );
+
+    cbuff = CircularBuffer.create();
+    cbuff.options.mode           = tests[kind].modes[round % tests[kind].mode_count];
+    cbuff.options.power_of_two   = ( ( round / tests[kind].mode_count ) % 2 == 1 );
+    cbuff.options.blocking_write = true;
+    cbuff.options.resizable      = ( kind == TEST_RESIZE || kind == TEST_TRIM );
+    cbuff.options.wake_threshold = ( kind == TEST_WAKE ? ( 3 * WRITE_CHUNKS ) : 0 );
+
+    if( kind == TEST_CHUNK && variant % 2 == 1 ) {
+        cbuff.options.wait = (CircularBuffer_WaitStrategy_t) { .spins = 1000, .yields = 10, .park = CIRCULARBUFFER_PARK_FUTEX };
+    }
+
+    if( ( kind == TEST_CHUNK && variant / 2 % 2 == 1 ) || ( kind == TEST_CRC && variant % 2 == 1 ) ) {
+        cbuff.options.copy_kernel = CIRCULARBUFFER_COPY_AUTO;
+    }
+
+    if( kind == TEST_TRIM ) { //odd variants auto-trim, variants 2-3 are prefaulted
+        cbuff.options.trim_interval = ( variant % 2 == 1 ? 1 : 0 );
+        cbuff.options.prefault      = ( variant >= 2 );
+    }
+
+    if( kind == TEST_HUGE )
+        cbuff.options.huge_page_size = HUGE_PAGE_SIZE;
+
+    if( kind == TEST_NUMA ) {
+        cbuff.options.numa     = ( variant == 0 ? CIRCULARBUFFER_NUMA_BIND : CIRCULARBUFFER_NUMA_INTERLEAVE );
+        cbuff.options.numa_cpu = 0;
+    }
+
+    if( kind == TEST_LOCK )
+        cbuff.options.lock_pages = true;
+
+    CircularBuffer.init( &cbuff, CBUFFER_SIZE );
+
+    if( kind == TEST_BROADCAST ) {
+        success = ( CircularBuffer.addReader( &cbuff ) == 0 && CircularBuffer.addReader( &cbuff ) == 1 );
+    }
+
+    success = ( openIo() && success );
+
+    u_int64_t start = getTime();
+
+    if( ( ret = pthread_create( &source.thread, NULL, launchProducer, NULL ) ) != 0 ) {
+        fprintf( stderr, "Failed to create producer thread (%d)\n", ret );
+    }
+
+    if( ( ret = pthread_create( &target.thread, NULL, launchConsumer, NULL ) ) != 0 ) {
+        fprintf( stderr, "Failed to create consumer thread (%d)\n", ret );
+    }
+
+    if( kind == TEST_BROADCAST && ( ret = pthread_create( &mirror.thread, NULL, launchMirror, NULL ) ) != 0 ) {
+        fprintf( stderr, "Failed to create second reader thread (%d)\n", ret );
+    }
+
+    if( kind == TEST_FD && !( helper = ( ( ret = pthread_create( &io.thread, NULL, launchFeeder, NULL ) ) == 0 ) ) ) {
+        fprintf( stderr, "Failed to create feeder thread (%d)\n", ret );
+    }
+
+    if( io.uring.cbuff != NULL && !( helper = ( ( ret = pthread_create( &io.thread, NULL, launchEngine, NULL ) ) == 0 ) ) ) {
+        fprintf( stderr, "Failed to create io_uring engine thread (%d)\n", ret );
+    }
+
+    if( kind == TEST_RESIZE ) { //grows the buffer twice mid-transfer, once the content has wrapped
+        usleep( 5000 + rand() % 10000 );
+        success = CircularBuffer.resize( &cbuff, ( 2 * CBUFFER_SIZE ) );
+        usleep( rand() % 10000 );
+        success = ( CircularBuffer.resize( &cbuff, ( 4 * CBUFFER_SIZE ) ) && success );
+    }
+
+    if( kind == TEST_TRIM && variant % 2 == 0 ) { //releases the free range mid-transfer (refused when prefaulted)
+        usleep( 5000 + rand() % 10000 );
+        success = ( CircularBuffer.trim( &cbuff ) == !cbuff.options.prefault );
+    }
+
+    pthread_join( target.thread, NULL );
+    pthread_join( source.thread, NULL );
+
+    if( kind == TEST_BROADCAST )
+        pthread_join( mirror.thread, NULL );
+
+    if( helper )
+        pthread_join( io.thread, NULL );
+
+    u_int64_t end = getTime();
+
+    if( kind == TEST_TRIM ) { //the drained buffer drops back to about no pages held, unless prefaulted
+        u_int8_t probe = 0;
+
+        if( variant % 2 == 1 ) { //idle windows closed by consumer calls (their clock ticks at the kernel's HZ)
+            for( int i = 0; i < 3; ++i ) {
+                usleep( 10000 );
+                CircularBuffer.tryReadChunk( &cbuff, &probe, 1 );
+            }
+        } else {
+            success = ( CircularBuffer.trim( &cbuff ) == !cbuff.options.prefault && success );
+        }
+
+        const CircularBuffer_Stats_t stats = CircularBuffer.stats( &cbuff );
+
+        success = ( ( cbuff.options.prefault ? ( stats.resident == stats.size ) : ( stats.resident < stats.size ) ) && success );
+    }
+
+    if( kind == TEST_DEADLINE )
+        success = ( checkDeadlines() && success );
+
+    if( kind == TEST_BROADCAST ) { //a reader removed twice, then the other modes
+        u_int8_t probe = 0;
+
+        CircularBuffer.removeReader( &cbuff, 1 );
+        CircularBuffer.removeReader( &cbuff, 1 );
+        success = ( CircularBuffer.readChunkAs( &cbuff, 1, &probe, 1 ) == 0 && checkRemoveReader() && success );
+    }
+
+    if( kind == TEST_PARTIAL )
+        success = ( checkPartial() && success );
+
+    if( kind == TEST_WAKE )
+        success = ( checkWakeThreshold() && success );
+
+    if( kind == TEST_RESERVE )
+        success = ( checkSharedCommit() && checkSharedConsume() && success );
+
+    if( kind == TEST_CHUNK )
+        success = ( checkStreamCopy() && success );
+
+    if( kind == TEST_RESIZE && cbuff.options.mode == CIRCULARBUFFER_MODE_SPSC )
+        success = ( checkFdPinned( false ) && checkFdPinned( true ) && checkDrainPinned() && success );
+
+    if( kind == TEST_FD )
+        success = ( checkFdUnlocked( false ) && checkFdUnlocked( true ) && checkDrainUnlocked() && success );
+
+    if( kind == TEST_HUGE )
+        success = ( checkHugePages( CircularBuffer.stats( &cbuff ) ) && success );
+
+    if( kind == TEST_URING )
+        success = ( checkUringTeardown() && success );
+
+    if( kind == TEST_NUMA )
+        success = ( checkNuma( cbuff.options.numa ) && success );
+
+    if( kind == TEST_LOCK )
+        success = ( checkLockedPages( &locked ) && success );
+
+    printBuffToFile( in, source.buffer, BYTES );
+    printBuffToFile( out, target.buffer, BYTES );
+
+//    printf( "\n=== OUT ====\n" );
+//    size_t diff = compareBuff( source.buffer, target.buffer, BYTES );
+//    printf( "\n===========\n" );
+
+    fclose( in );
+    fclose( out );
+    closeIo();
+    CircularBuffer.free( &cbuff );
+
+    if( time )
+        *time = ( end - start );
+
+    if( kind == TEST_CRC )
+        success = ( io.crc[0] == io.crc[1] && checkCrcVectors() && success );
+
+    if( kind == TEST_LOCK ) //unlocked with the mapping
+        success = ( lockedBytes() <= locked && success );
+
+    if( kind == TEST_BROADCAST )
+        success = ( checkEqual( source.buffer, mirror.buffer, BYTES ) && success );
+
+    success = ( !atomic_load( &failed ) && success );
+
+    return ( checkEqual( source.buffer, target.buffer, BYTES ) && success );
+}
+
+int main() {
+    int test_count  = 0;
+    int test_number = 0;
+
+    for( int kind = 0; kind < TEST_COUNT; ++kind ) {
+        test_count += tests[kind].rounds;
+    }
+
+    u_int64_t    timers[test_count];
+    u_int64_t    checks[test_count];
+    const char * names[test_count];
+
+    for( int kind = 0; kind < TEST_COUNT; ++kind ) {
+        for( int round = 0; round < tests[kind].rounds; ++round ) {
+            names[test_number]  = tests[kind].name;
+            checks[test_number] = run( (Test_e) kind, round, &timers[test_number] );
+            ++test_number;
+        }
+    }
 
     u_int64_t average = timers[0];
 
     for( int i = 0; i < test_count; ++i ) {
-        printf( "Test #%d: %s (%lu)\n", i, ( checks[i] ? "\x1b[32mPASSED\033[0m" : "\x1b[31mFAILED\033[0m" ), timers[i] );
+        printf( "Test #%d: %s (%lu) %s\n", i, ( checks[i] ? "\x1b[32mPASSED\033[0m" : "\x1b[31mFAILED\033[0m" ), timers[i], names[i] );
 
         if( i > 0 ) {
             average += timers[ i ];